@@ -0,0 +1,107 @@
+/** Goldilocks Bench
+ * Version: 2.0
+ *
+ * Times the internals of Goldilocks that scale with the number of samples,
+ * so that changes to them can be measured.
+ *
+ * Author(s): Jason C. McDonald
+ */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2016-2019 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "goldilocks/benchmark_results.hpp"
+
+namespace {
+	/// How many times to finalize each size, to take the best of.
+	const int ROUNDS = 3;
+
+	/**Time BenchmarkResult::finalize() on raw samples. The samples are
+	 * lognormal, like real timings, and the same on every round.
+	 * \param the number of pairs of measurements
+	 * \return the best time taken to finalize, in seconds
+	 */
+	double time_finalize(uint64_t pairs)
+	{
+		double best = 0;
+		for (int round = 0; round < ROUNDS; ++round) {
+			std::mt19937_64 generator(1);
+			std::lognormal_distribution<double> timing(5, 0.3);
+
+			BenchmarkResult result;
+			result.reserve(pairs);
+			for (uint64_t i = 0; i < pairs; ++i) {
+				result.add_measurement(static_cast<uint64_t>(timing(generator)),
+									   static_cast<uint64_t>(timing(generator)));
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			result.finalize();
+			std::chrono::duration<double> taken =
+				std::chrono::steady_clock::now() - start;
+			if (round == 0 || taken.count() < best) {
+				best = taken.count();
+			}
+		}
+		return best;
+	}
+}  // namespace
+
+/** Times finalize() on each number of pairs given on the command line,
+ * or on 1e6 and 1e8 pairs if none are given. 1e8 pairs need about 2 GB.
+ */
+int main(int argc, char* argv[])
+{
+	std::vector<uint64_t> sizes;
+	for (int i = 1; i < argc; ++i) {
+		sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+	}
+	if (sizes.empty()) {
+		sizes = {1000000, 100000000};
+	}
+
+	for (uint64_t pairs : sizes) {
+		std::cout << "finalize " << pairs << " pairs: " << time_finalize(pairs)
+				  << " s (best of " << ROUNDS << ")" << std::endl;
+	}
+	return 0;
+}
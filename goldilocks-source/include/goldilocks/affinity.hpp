@@ -0,0 +1,160 @@
+/** Affinity [Goldilocks]
+ * Version: 2.0
+ *
+ * Controls which CPU the benchmark thread runs on, and how it is scheduled,
+ * and detects when it moves.
+ *
+ * Author(s): Wilfrantz DEDE, Manuel Mateo, Jason C. McDonald
+ */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_AFFINITY_HPP
+#define GOLDILOCKS_AFFINITY_HPP
+
+#include <cstdint>
+#include <vector>
+
+// MACRO IF the platform lets us pin threads and ask which CPU we're on.
+#if defined __linux__
+#define GOLDILOCKS_HAS_AFFINITY 1
+#else
+#define GOLDILOCKS_HAS_AFFINITY 0
+#endif
+
+/// Whether something the options asked of the scheduler took effect.
+enum class Granted {
+	/// The options didn't ask for it.
+	not_asked,
+	/// It took effect.
+	granted,
+	/// The OS refused, for want of privileges or support.
+	refused
+};
+
+/// Where, and how, a benchmark's thread ran.
+struct Placement {
+	/// The CPU the test was measured on, or -1 if it wasn't pinned.
+	int cpu_test = -1;
+
+	/// The CPU the comparative was measured on, or -1 if it wasn't pinned.
+	int cpu_comparative = -1;
+
+	/// Whether the thread was pinned.
+	Granted pinning = Granted::not_asked;
+
+	/// Whether the thread ran under SCHED_FIFO.
+	Granted realtime = Granted::not_asked;
+
+	/// Whether the process's memory was locked.
+	Granted memory_lock = Granted::not_asked;
+
+	/// How many pairs were measured while the thread changed CPU.
+	uint64_t migrations = 0;
+
+	/** How many pairs were measured while the thread was preempted (but
+	 * stayed on its CPU).*/
+	uint64_t preemptions = 0;
+
+	/// How many of those pairs were discarded and measured again.
+	uint64_t discarded = 0;
+};
+
+/**Find the CPU the calling thread is running on. This reads TSC_AUX
+ * with rdtscp, where Linux keeps the CPU number, or else asks the OS.
+ * \return the CPU number, or -1 if it can't be found
+ */
+int current_cpu();
+
+/**Count the times the calling thread has been preempted: switched out
+ * involuntarily, rather than because it blocked.
+ * \return the count so far, or 0 if the platform doesn't keep one
+ */
+uint64_t preemption_count();
+
+/** Places the calling thread on a CPU, at real-time priority, and with
+ * the process's memory locked, as asked. Everything it changed is put
+ * back when it goes out of scope.*/
+class ThreadPlacement
+{
+protected:
+	/// The CPU the thread is pinned to, or -1 if we haven't pinned it.
+	int pinned = -1;
+
+	/// The thread's affinity before we pinned it, as a raw cpu_set_t.
+	std::vector<unsigned char> saved_affinity;
+
+	/// Whether we changed the thread's scheduling policy.
+	bool rescheduled = false;
+
+	/// The thread's scheduling policy before we changed it.
+	int saved_policy = 0;
+
+	/// The thread's scheduling priority before we changed it.
+	int saved_priority = 0;
+
+	/// Whether we locked the process's memory.
+	bool locked = false;
+
+public:
+	ThreadPlacement() = default;
+	ThreadPlacement(const ThreadPlacement&) = delete;
+	ThreadPlacement& operator=(const ThreadPlacement&) = delete;
+
+	/**Pin the calling thread to a CPU. Pinning it to the CPU it is
+	 * already pinned to costs nothing.
+	 * \param the CPU to pin to
+	 * \return true if pinned, else false
+	 */
+	bool pin(int);
+
+	/**Run the calling thread under SCHED_FIFO, so that only threads of
+	 * higher real-time priority can preempt it.
+	 * \param the priority, 1 (lowest) to 99
+	 * \return true if the policy took effect, else false
+	 */
+	bool make_realtime(int);
+
+	/**Lock the process's memory, now and as it grows, so that page
+	 * faults can't land in measurements.
+	 * \return true if locked, else false
+	 */
+	bool lock_memory();
+
+	~ThreadPlacement();
+};
+
+#endif  // GOLDILOCKS_AFFINITY_HPP
@@ -0,0 +1,109 @@
+/** Allocation Tracker [Goldilocks]
+ * Version: 2.0
+ *
+ * Counts the heap allocations a thread makes, by replacing the global
+ * operator new and operator delete.
+ *
+ * Author(s): Wilfrantz DEDE, Manuel Mateo, Jason C. McDonald
+ */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_ALLOC_TRACKER_HPP
+#define GOLDILOCKS_ALLOC_TRACKER_HPP
+
+#include <cstdint>
+
+/* MACRO IF allocations are counted at all. This replaces operator new and
+ * operator delete for any program that links the library, which would get
+ * in the way of another allocator (or a sanitizer), and so must be asked
+ * for when building: set TRACK_ALLOCATIONS in the build .config. */
+#ifndef GOLDILOCKS_TRACK_ALLOCATIONS
+#define GOLDILOCKS_TRACK_ALLOCATIONS 0
+#endif
+
+/* MACRO IF malloc() and free() are counted too, and not only operator new
+ * and operator delete. This replaces them for the whole program as well,
+ * and so must also be asked for when building (set TRACK_MALLOC); it needs
+ * glibc, and does nothing without GOLDILOCKS_TRACK_ALLOCATIONS. */
+#ifndef GOLDILOCKS_TRACK_MALLOC
+#define GOLDILOCKS_TRACK_MALLOC 0
+#endif
+
+/// What a thread allocated while it was tracked.
+struct AllocCounts {
+	/// How many blocks were allocated.
+	uint64_t allocations = 0;
+
+	/// How many blocks were freed.
+	uint64_t frees = 0;
+
+	/// How many bytes were asked for, over every allocation.
+	uint64_t bytes = 0;
+};
+
+/** Counts the heap allocations of the calling thread, between start()
+ * and stop(). Allocations on other threads are never counted, so tests
+ * (or benchmarks) on different threads can't see each other's. Tracking
+ * nests, so an expectation can track inside a tracked benchmark. While no
+ * thread is tracking, each allocation costs one more thread-local test.
+ * Nothing is counted unless the library was built to track allocations.*/
+class AllocTracker
+{
+public:
+	AllocTracker() = delete;
+
+	/**Check whether allocations can be counted at all, which they can
+	 * only be if the library was built with GOLDILOCKS_TRACK_ALLOCATIONS.
+	 * \return true if allocations are counted, else false
+	 */
+	static bool enabled();
+
+	/**Start counting the calling thread's allocations. Every start()
+	 * needs its own stop().
+	 * \return the mark to pass to stop()
+	 */
+	static AllocCounts start();
+
+	/**Stop counting the calling thread's allocations, unless an outer
+	 * start() is still tracking.
+	 * \param the mark the matching start() returned
+	 * \return what was counted since that start()
+	 */
+	static AllocCounts stop(const AllocCounts&);
+};
+
+#endif  // GOLDILOCKS_ALLOC_TRACKER_HPP
@@ -0,0 +1,261 @@
+/** Benchmark Options [Goldilocks]
+ * Version: 2.0
+ *
+ * Per-run configuration for benchmarking.
+ *
+ * Author(s): Wilfrantz Dede, Jason C. McDonald
+ */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2016-2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_BENCHMARK_OPTIONS_HPP
+#define GOLDILOCKS_BENCHMARK_OPTIONS_HPP
+
+#include "goldilocks/affinity.hpp"
+#include "goldilocks/benchmark_results.hpp"
+#include "goldilocks/clock.hpp"
+#include "goldilocks/isolation.hpp"
+#include "goldilocks/sequential_test.hpp"
+
+/// The order in which the test and comparative are measured in each pair.
+enum class Interleave {
+	/// Always the test, then the comparative: AB AB AB AB.
+	sequential,
+	/// Swap the order every pair: AB BA AB BA.
+	alternating,
+	/// Counterbalanced blocks of four pairs: AB BA BA AB.
+	abba,
+	/// A seeded coin flip for every pair.
+	random
+};
+
+/** Configuration for a single BenchmarkRunner.
+ * The defaults are suitable for most benchmarks; change only what
+ * you need to.
+ */
+struct BenchmarkOptions {
+	/// The clock source to measure with. Automatic picks the best one.
+	ClockSource clock_source = ClockSource::automatic;
+
+	/// Whether to subtract the measured clock overhead from every sample.
+	bool subtract_overhead = true;
+
+	/// How many empty measurements to take when measuring clock overhead.
+	uint32_t overhead_samples = 1000;
+
+	/** How many times to run a test inside each measurement, with the
+	 * sample recorded as the per-run time. 1 disables batching; 0 picks
+	 * the batch size automatically to meet batch_target_ns.
+	 * janitor() is called only once per batch, so only batch tests which
+	 * can be repeated without being cleaned up. */
+	uint64_t batch_size = 1;
+
+	/// How long each batched measurement should take, in nanoseconds.
+	double batch_target_ns = 10000;
+
+	/// The largest batch size automatic batching will choose.
+	uint64_t batch_size_max = 1ULL << 30;
+
+	/// The order in which the test and comparative are measured.
+	Interleave interleave = Interleave::alternating;
+
+	/// The seed for randomized parts of a run, so they can be reproduced.
+	uint64_t seed = 0x5EED;
+
+	/// The hypothesis test the verdict is judged with.
+	VerdictMethod verdict_method = VerdictMethod::paired_t;
+
+	/// The significance level of the verdict.
+	double alpha = 0.05;
+
+	/** The adjusted RSD (in percent) of either series above which the
+	 * verdict is questionable. */
+	double max_rsd = 50;
+
+	/** Which samples count as outliers, and so are left out of the
+	 * adjusted statistics. Streaming storage only supports Tukey's fences
+	 * (or none). */
+	OutlierPolicy outliers;
+
+	/** How many bootstrap resamples to take for confidence intervals of
+	 * the means, medians and ratio of medians, or 0 for none. Needs raw
+	 * storage. Resampling can take far longer than the rest of the
+	 * statistics put together, so it is off unless asked for; 2000 is a
+	 * good number to ask for. */
+	uint32_t bootstrap_resamples = 0;
+
+	/// How many threads to bootstrap with, or 0 for one per core.
+	uint32_t bootstrap_threads = 0;
+
+	/** Whether to warm both tests up until their measurements settle,
+	 * before taking any samples. */
+	bool warmup = true;
+
+	/// The least time to spend warming up, in nanoseconds.
+	uint64_t warmup_min_ns = 0;
+
+	/** The most time to spend warming up, in nanoseconds. Sampling starts
+	 * then, even if the measurements haven't settled. */
+	uint64_t warmup_max_ns = 1000000000;
+
+	/// How many measurements of each test make up a warmup window.
+	uint32_t warmup_window = 16;
+
+	/** How far apart (as a fraction) the medians of the last few warmup
+	 * windows may be for a test to count as warmed up. */
+	double warmup_tolerance = 0.02;
+
+	/** How many pairs to take in a pilot run before the real one, to
+	 * estimate how many pairs are needed, or 0 for no pilot. */
+	uint64_t pilot_samples = 0;
+
+	/** The smallest difference the pilot sizes the run to detect, as a
+	 * fraction of the comparative's mean, e.g. 0.01 for 1%. */
+	double detectable_difference = 0.01;
+
+	/// The chance of detecting that difference the pilot sizes for.
+	double power = 0.8;
+
+	/** Whether the pilot's advice replaces the budget's iteration count.
+	 * Time limits in the budget still apply. */
+	bool apply_pilot = false;
+
+	/// The most iterations the pilot's advice may set.
+	uint64_t pilot_max_iterations = 10000000;
+
+	/** Whether to stop before the budget is used up, once the verdict is
+	 * significant at alpha, or the difference is known to within
+	 * early_stop_precision. The budget is still the most that is taken. */
+	EarlyStop early_stop = EarlyStop::none;
+
+	/// How many pairs to take between checks for stopping early.
+	uint64_t early_stop_interval = 100;
+
+	/** The confidence interval half-width of the difference to stop at,
+	 * as a fraction of the comparative's mean. */
+	double early_stop_precision = 0.01;
+
+	/** Where the benchmark runs. A child process starts from a clean heap
+	 * and cache, and a crash or hang there fails this benchmark alone. */
+	Isolation isolation = Isolation::none;
+
+	/** The most time an isolated benchmark, or a single reset snapshot,
+	 * may take, in nanoseconds, or 0 for no limit. Children still running
+	 * then are killed, and the benchmark fails. */
+	uint64_t isolation_timeout_ns = 0;
+
+	/** How each measurement starts from a clean state. Snapshots suit
+	 * fixtures that cost far more to reset than to use. Each side runs
+	 * alone in side isolation, so it always resets by janitor() there. */
+	Reset reset = Reset::janitor;
+
+	/** How many measurements each snapshot takes in a row, to spread the
+	 * cost of forking. Only the first starts from the pristine fixture. */
+	uint32_t snapshot_measurements = 1;
+
+	/** The CPU to pin the benchmark thread to while measuring the test,
+	 * or -1 to leave it where the scheduler puts it. */
+	int cpu_test = -1;
+
+	/** The CPU to pin the benchmark thread to while measuring the
+	 * comparative, or -1 for the test's. A different CPU moves the thread
+	 * before every measurement. When each side is isolated, the sides run
+	 * at once, so -1 means the CPU after the test's. */
+	int cpu_comparative = -1;
+
+	/** Whether to run the benchmark thread under SCHED_FIFO, so nothing
+	 * of lower priority preempts it. This needs privileges; the report
+	 * says if the OS refused. A test that never blocks can starve other
+	 * work on its CPU for as long as it runs. */
+	bool realtime = false;
+
+	/// The SCHED_FIFO priority to run at, 1 (lowest) to 99.
+	int realtime_priority = 1;
+
+	/** Whether to lock the process's memory with mlockall(), so that page
+	 * faults can't land in measurements. */
+	bool lock_memory = false;
+
+	/** Whether to discard, and measure again, pairs in which the thread
+	 * changed CPU. They are counted either way. */
+	bool discard_migrations = true;
+
+	/** Whether to discard, and measure again, pairs in which the thread
+	 * was preempted. Tukey's fences only catch the longest preemptions.
+	 * They are counted either way. The test blocking is not preemption,
+	 * and is kept as part of what it costs. */
+	bool discard_preemptions = true;
+
+	/** Whether to count hardware and software events (instructions,
+	 * cache misses, page faults and so on) around each measurement. Where
+	 * the PMU is unavailable, only the software events are counted. They
+	 * aren't counted with snapshots, which measure in other processes. */
+	bool collect_counters = false;
+
+	/** Whether to count the heap allocations, frees and bytes allocated
+	 * by each run, on the benchmark's thread. Nothing pre() or janitor()
+	 * allocates is counted. Nothing is counted unless the library was
+	 * built with GOLDILOCKS_TRACK_ALLOCATIONS, and only operator new is
+	 * seen unless it was also built with GOLDILOCKS_TRACK_MALLOC. They
+	 * aren't counted with snapshots either. */
+	bool track_allocations = false;
+
+	/** What the verdict is judged on. Instructions are counted whether or
+	 * not collect_counters is set, and suit gating on noisy machines; the
+	 * times are still reported. Without the PMU (or with snapshots), the
+	 * verdict falls back to time, and the report says so. */
+	Metric metric = Metric::time;
+
+	/** The smallest difference in instructions per run, as a fraction of
+	 * the comparative's, that can win or lose, e.g. 0.001 for 0.1%. The
+	 * counts barely vary, so almost any difference is significant. */
+	double instruction_tolerance = 0.001;
+
+	/** How samples are stored. Streaming keeps memory constant for very
+	 * long runs, at the cost of approximate quartiles and outliers.
+	 * Histograms keep memory fixed, with tail percentiles to a few
+	 * significant figures. */
+	SampleStorage storage = SampleStorage::raw;
+
+	/// The largest measurement (in ticks) a histogram tracks precisely.
+	uint64_t histogram_highest = HdrHistogram::DEFAULT_HIGHEST;
+
+	/// How many significant figures (1-5) a histogram preserves.
+	uint8_t histogram_significant_figures =
+		HdrHistogram::DEFAULT_SIGNIFICANT_FIGURES;
+};
+
+#endif  // GOLDILOCKS_BENCHMARK_OPTIONS_HPP
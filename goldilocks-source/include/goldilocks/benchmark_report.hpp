@@ -44,101 +44,464 @@
 
 #ifndef BENCHMARK_REPORT_HPP
 #define BENCHMARK_REPORT_HPP
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "goldilocks/benchmark_results.hpp"
 #include "report_base.hpp"
 
 class BenchmarkReport : public ReportBase
 {
-private:
-	BenchmarkVerdict verdict;
-
-	/// Vector to store the raw measurements
-	std::vector<uint64_t> results;
-
-	/// The accumulated count.
-	uint64_t acc = 0;
-
-	/// The adjusted accumulated count.
-	uint64_t acc_adj = 0;
-
-	/// The number of repetitions (size).
-	uint64_t repeat = 0;
-
-	/// The average (mean).
-	uint64_t mean = 0;
-
-	/// The adjusted average (mean).
-	uint64_t mean_adj = 0;
-
-	/// The median value.
-	uint64_t median = 0;
-
-	/// The lower quartile value.
-	uint64_t q1 = 0;
-
-	/// The upper quartile value.
-	uint64_t q3 = 0;
-
-	/// The range.
-	uint64_t range = 0;
-
-	/// The adjusted range.
-	uint64_t range_adj = 0;
-
-	/// The minimum value.
-	uint64_t min_val = 0;
-
-	/// The minimum non-outlier value.
-	uint64_t min_adj_val = 0;
-
-	/// The maximum value.
-	uint64_t max_val = 0;
-
-	/// The maximum non-outlier value.
-	uint64_t max_adj_val = 0;
-
-	/// Lower inner fence value.
-	uint64_t lif = 0;
-
-	/// Lower outer fence value
-	uint64_t lof = 0;
-
-	/// Upper inner fence value.
-	uint64_t uif = 0;
-
-	/// Upper outer fence value.
-	uint64_t uof = 0;
-
-	/// The number of low minor outliers
-	uint64_t low_out_minor = 0;
-
-	/// The number of low major outliers
-	uint64_t low_out_major = 0;
-
-	/// The number of upper minor outliers
-	uint64_t upp_out_minor = 0;
-
-	/// The number of upper major outliers
-	uint64_t upp_out_major = 0;
-
-	/// The standard deviance
-	double std_dev = 0;
-
-	/// The adjusted standard deviance
-	double std_dev_adj = 0;
-
-	/// The relative standard deviation (coefficient of variation)
-	uint8_t rsd = 0;
-
-	/// The adjusted relative standard deviation
-	uint8_t rsd_adj = 0;
-
-    public:
-
-    BenchmarkReport() : verdict(BenchmarkVerdict::none);
-    void lap() override;
-    ~BenchmarkReport() = default;
-    protected:
+public:
+	// Init report
+	BenchmarkReport() {}
+
+	// Add a finalized benchmark result to the report
+	void log(const BenchmarkResult& result)
+	{
+		const ClockCalibration& cal = result.calibration;
+		std::ostringstream out;
+
+		// A benchmark that didn't finish has nothing else worth showing.
+		if (result.status != Status::OK) {
+			out << "Status: FAILED (" << result.failure << ")\n";
+			reports.push_back(out.str());
+			return;
+		}
+
+		out << "Clock: " << clock_source_name(cal.source);
+		if (cal.source == ClockSource::tsc) {
+			out << " @ " << std::fixed << std::setprecision(3)
+				<< cal.ticks_per_ns << " cycles/ns"
+				<< (cal.invariant_tsc ? " (invariant)"
+									  : (cal.constant_tsc ? " (constant)"
+														  : " (NOT constant)"));
+		}
+		out << "\n";
+
+		out << "Clock overhead: " << format(cal, result.overhead.estimate)
+			<< " subtracted, noise floor "
+			<< format(cal, result.overhead.noise_floor) << "\n";
+		if (result.below_noise_floor) {
+			out << "WARNING: A mean is within the clock overhead noise floor.\n";
+		}
+
+		const size_t modes_a = result.stats_a.modality.modes.size();
+		const size_t modes_b = result.stats_b.modality.modes.size();
+		if (modes_a > 1 || modes_b > 1) {
+			out << "WARNING: The test has " << modes_a
+				<< " mode(s) and the comparative " << modes_b
+				<< "; a difference may be a shift in how often each mode "
+				   "occurs, rather than in its speed.\n";
+		}
+
+		if (result.batch_test > 1 || result.batch_comparative > 1) {
+			out << "Batch size (test/comparative): " << result.batch_test << "/"
+				<< result.batch_comparative << " runs per measurement\n";
+		}
+
+		if (result.storage == SampleStorage::streaming) {
+			out << "Storage: streaming (quartiles and outliers are estimates)\n";
+		} else if (result.storage == SampleStorage::histogram) {
+			out << "Storage: histogram ("
+				<< (int)result.hist_a->get_significant_figures()
+				<< " significant figures)\n";
+			uint64_t clamped = result.hist_a->size_clamped() +
+							   result.hist_b->size_clamped();
+			if (clamped > 0) {
+				out << "WARNING: " << clamped
+					<< " measurements exceeded the histogram range.\n";
+			}
+		}
+
+		out << "Warmup (test): " << compose_warmup(result.warmup_a) << "\n";
+		out << "Warmup (comparative): " << compose_warmup(result.warmup_b)
+			<< "\n";
+
+		out << "Placement: " << compose_placement(result.placement) << "\n";
+		const Placement& placed = result.placement;
+		if (placed.migrations > 0 || placed.preemptions > 0) {
+			out << "WARNING: The thread changed CPU during "
+				<< placed.migrations << " pairs and was preempted during "
+				<< placed.preemptions << " (" << placed.discarded
+				<< " discarded).\n";
+		}
+
+		if (result.counters_requested) {
+			out << compose_counters(result);
+		}
+
+		out << "Reset ("
+			<< (result.reset == Reset::snapshot ? "snapshot" : "janitor")
+			<< "): test "
+			<< compose_reset(cal,
+							 result.reset_ns_a,
+							 result.stats_a.mean * result.batch_test)
+			<< ", comparative "
+			<< compose_reset(cal,
+							 result.reset_ns_b,
+							 result.stats_b.mean * result.batch_comparative)
+			<< "\n";
+
+		const PowerAdvice& advice = result.power_advice;
+		if (advice.pilot_samples > 0) {
+			out << "Pilot (" << advice.pilot_samples << " pairs): ";
+			if (advice.required_samples > 0) {
+				out << advice.required_samples << " pairs";
+			} else {
+				out << "unknown pairs";
+			}
+			out << " to detect a " << std::fixed << std::setprecision(1)
+				<< advice.relative_difference * 100 << "% difference with "
+				<< advice.power * 100 << "% power at alpha "
+				<< std::setprecision(3) << advice.alpha
+				<< (advice.applied ? " (applied)" : "") << "\n";
+		}
+
+		if (result.early_stop != EarlyStop::none) {
+			out << "Stopped early after " << result.size() << " pairs ("
+				<< ((result.early_stop == EarlyStop::significance)
+						? "significant"
+						: "precise enough")
+				<< " at check " << result.early_stop_looks << ")\n";
+		}
+
+		if (result.metric == Metric::instructions) {
+			out << "Verdict: " << verdict_name(result.verdict)
+				<< " (by instructions)\n";
+			out << compose_instructions(result);
+		} else {
+			if (result.metric_requested == Metric::instructions) {
+				out << "WARNING: Instructions couldn't be counted; the "
+					   "verdict is judged on time.\n";
+			}
+			out << "Verdict: " << verdict_name(result.verdict) << "\n";
+		}
+		out << "Test:\n" << compose_series(cal, result.stats_a);
+		out << "Comparative:\n" << compose_series(cal, result.stats_b);
+		if (result.size() > 1) {
+			const HypothesisTest& test = result.comparison;
+			out << "Paired difference (test - comparative): "
+				<< format(cal, result.diff_mean) << " +/- "
+				<< format(cal, result.diff_std_dev) << "\n";
+			out << verdict_method_name(test.method) << ": "
+				<< format(cal, test.estimate) << ", " << std::fixed
+				<< std::setprecision(1) << test.confidence * 100 << "% CI ["
+				<< format(cal, test.ci_low) << ", "
+				<< format(cal, test.ci_high) << "]\n";
+			// Rank tests have no degrees of freedom, and a different effect.
+			const bool ranked = (test.method == VerdictMethod::mann_whitney);
+			out << (ranked ? "  U = " : "  t = ") << std::setprecision(2)
+				<< test.statistic;
+			if (!ranked) {
+				out << ", df = " << test.df;
+			}
+			out << ", p = " << std::setprecision(4) << test.p
+				<< (ranked ? ", rank-biserial r = " : ", Cohen's d = ")
+				<< std::setprecision(3) << test.effect_size << "\n";
+		}
+		const BootstrapResult& boot = result.bootstrap;
+		if (boot.resamples > 0) {
+			out << "Bootstrap (" << boot.resamples << " resamples, "
+				<< std::fixed << std::setprecision(1) << boot.confidence * 100
+				<< "% CI):\n";
+			out << "  Test mean: " << compose_interval(cal, boot.mean_a)
+				<< "\n";
+			out << "  Test median: " << compose_interval(cal, boot.median_a)
+				<< "\n";
+			out << "  Comparative mean: " << compose_interval(cal, boot.mean_b)
+				<< "\n";
+			out << "  Comparative median: "
+				<< compose_interval(cal, boot.median_b) << "\n";
+			out << "  Median ratio (test/comparative): " << std::setprecision(4)
+				<< boot.median_ratio.estimate << " ["
+				<< boot.median_ratio.low << ", " << boot.median_ratio.high
+				<< "]\n";
+		}
+		reports.push_back(out.str());
+	}
+
+	// Ensures that the benchmark run is complete
+	void lap() override { reports.push_back("End of benchmark. \n"); }
+
+	// Prints out the reports for the benchmark
+	void print_report()
+	{
+		for (const auto& report : reports) {
+			std::cout << report;
+		}
+	}
+
+	// Destructor
+	~BenchmarkReport() { reports.clear(); }
+
+protected:
+	/* Compose the statistics of a single series.
+	 * \param cal The calibration of the clock the ticks came from
+	 * \param stats The statistics of the series
+	 * \return the composed statistics
+	 */
+	static std::string compose_series(const ClockCalibration& cal,
+									  const SeriesStats& stats)
+	{
+		std::ostringstream out;
+		out << "  Repetitions: " << stats.repeat << "\n";
+		out << "  Mean: " << format(cal, stats.mean) << "\n";
+		out << "  Median: " << format(cal, stats.median) << "\n";
+		out << "  p99: " << format(cal, stats.p99) << "\n";
+		out << "  p99.9: " << format(cal, stats.p999) << "\n";
+		out << "  p99.99: " << format(cal, stats.p9999) << "\n";
+		out << "  Q1: " << format(cal, stats.q1) << "\n";
+		out << "  Q3: " << format(cal, stats.q3) << "\n";
+		out << "  Min: " << format(cal, stats.min_val) << "\n";
+		out << "  Max: " << format(cal, stats.max_val) << "\n";
+		out << "  Range: " << format(cal, stats.range) << "\n";
+		out << "  Std dev: " << format(cal, stats.std_dev) << "\n";
+		out << "  RSD: " << std::fixed << std::setprecision(2) << stats.rsd
+			<< "%\n";
+		out << "  Adjusted mean: " << format(cal, stats.mean_adj) << "\n";
+		out << "  Adjusted range: " << format(cal, stats.range_adj) << "\n";
+		out << "  Adjusted std dev: " << format(cal, stats.std_dev_adj) << "\n";
+		out << "  Adjusted RSD: " << std::fixed << std::setprecision(2)
+			<< stats.rsd_adj << "%\n";
+		out << "  Outliers (" << outlier_method_name(stats.outliers.method);
+		if (stats.outliers.method != OutlierMethod::none) {
+			out << ", k = " << std::setprecision(2) << stats.outliers.k;
+		}
+		out << "; low minor/major, high minor/major): " << stats.low_out_minor
+			<< "/" << stats.low_out_major << ", " << stats.upp_out_minor << "/"
+			<< stats.upp_out_major << "\n";
+		if (stats.repeat > 0) {
+			out << "  Retained ranks: " << stats.retained_first << " to "
+				<< stats.retained_last << " of " << stats.repeat << "\n";
+		}
+		const Modality& shape = stats.modality;
+		if (!shape.modes.empty()) {
+			out << "  Skewness: " << std::setprecision(2) << shape.skewness
+				<< ", excess kurtosis: " << shape.kurtosis
+				<< ", bimodality coefficient: " << std::setprecision(3)
+				<< shape.bimodality << "\n";
+			out << "  Modes:";
+			for (const DistributionMode& mode : shape.modes) {
+				out << " " << format(cal, mode.location) << " ("
+					<< std::setprecision(1) << mode.weight * 100 << "%)";
+			}
+			out << "\n";
+		}
+		return out.str();
+	}
+
+	/* Compose how a test warmed up.
+	 * \param warmup How the test warmed up
+	 * \return the composed warmup
+	 */
+	static std::string compose_warmup(const WarmupResult& warmup)
+	{
+		std::ostringstream out;
+		out << "first run " << format_ns(warmup.first_run_ns);
+		if (warmup.iterations > 0) {
+			out << ", " << (warmup.steady ? "steady" : "not steady")
+				<< " after " << warmup.iterations << " runs in "
+				<< format_ns(warmup.duration_ns);
+		}
+		return out.str();
+	}
+
+	/* Compose where, and how, the benchmark's thread ran.
+	 * \param placement The placement of the thread
+	 * \return the composed placement
+	 */
+	static std::string compose_placement(const Placement& placement)
+	{
+		std::ostringstream out;
+		auto cpu = [](int cpu) {
+			return (cpu >= 0) ? "CPU " + std::to_string(cpu)
+							  : std::string("any CPU");
+		};
+		if (placement.pinning == Granted::granted) {
+			out << "test on " << cpu(placement.cpu_test) << ", comparative on "
+				<< cpu(placement.cpu_comparative);
+		} else {
+			out << (placement.pinning == Granted::refused ? "pinning refused"
+														 : "not pinned");
+		}
+		if (placement.realtime != Granted::not_asked) {
+			out << (placement.realtime == Granted::granted
+						? ", SCHED_FIFO"
+						: ", SCHED_FIFO refused");
+		}
+		if (placement.memory_lock != Granted::not_asked) {
+			out << (placement.memory_lock == Granted::granted
+						? ", memory locked"
+						: ", memory lock refused");
+		}
+		return out.str();
+	}
+
+	/* Compose the events counted per run of each side.
+	 * \param result The benchmark result
+	 * \return the composed counters, one per line
+	 */
+	static std::string compose_counters(const BenchmarkResult& result)
+	{
+		std::ostringstream out;
+		out << "Counters (per run, test vs comparative):";
+		if (result.counters == 0) {
+			out << " none available\n";
+			return out.str();
+		}
+		// The hardware counters come first, then software, then the heap.
+		const uint32_t hardware = counter_bit(Counter::task_clock) - 1;
+		const uint32_t perf = counter_bit(Counter::allocations) - 1;
+		if ((result.counters & perf) != 0 &&
+			(result.counters & hardware) == 0) {
+			out << " software only (no PMU)";
+		}
+		out << "\n" << std::fixed << std::setprecision(2);
+		for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+			const Counter counter = static_cast<Counter>(c);
+			if ((result.counters & counter_bit(counter)) == 0) {
+				continue;
+			}
+			if (result.counts_a[c].size() == 0 &&
+				result.counts_b[c].size() == 0) {
+				out << "  " << counter_name(counter) << ": not counted\n";
+				continue;
+			}
+			const double a = result.counts_a[c].mean();
+			const double b = result.counts_b[c].mean();
+			out << "  " << counter_name(counter) << ": " << a << " vs " << b;
+			if (b > 0) {
+				out << " (" << std::showpos << (a - b) / b * 100
+					<< std::noshowpos << "%)";
+			}
+			out << "\n";
+		}
+		return out.str();
+	}
+
+	/* Compose the comparison of the instructions counted per run, which
+	 * the verdict was judged on.
+	 * \param result The benchmark result
+	 * \return the composed comparison
+	 */
+	static std::string compose_instructions(const BenchmarkResult& result)
+	{
+		const size_t instructions = static_cast<size_t>(Counter::instructions);
+		const double b = result.counts_b[instructions].mean();
+		const HypothesisTest& test = result.instruction_comparison;
+		std::ostringstream out;
+		out << std::fixed << std::setprecision(2)
+			<< "Instructions (per run): test "
+			<< result.counts_a[instructions].mean() << ", comparative " << b
+			<< "\n";
+		out << "  " << verdict_method_name(test.method) << ": "
+			<< test.estimate;
+		if (b > 0) {
+			out << " (" << std::showpos << test.estimate / b * 100
+				<< std::noshowpos << "%)";
+		}
+		out << ", " << std::setprecision(1) << test.confidence * 100
+			<< "% CI [" << std::setprecision(2) << test.ci_low << ", "
+			<< test.ci_high << "], p = " << std::setprecision(4) << test.p
+			<< ", tolerance " << std::setprecision(2)
+			<< result.instruction_tolerance * 100 << "%\n";
+		return out.str();
+	}
+
+	/* Compose what resetting cost before each measurement, and how that
+	 * compares to the measurement itself.
+	 * \param cal The calibration of the clock the ticks came from
+	 * \param reset_ns The mean reset time, in nanoseconds
+	 * \param measurement_ticks The mean time of one measurement, in ticks
+	 * \return the composed reset cost
+	 */
+	static std::string compose_reset(const ClockCalibration& cal,
+									 double reset_ns,
+									 double measurement_ticks)
+	{
+		std::ostringstream out;
+		out << format_ns(reset_ns);
+		const double measurement_ns = cal.to_ns(measurement_ticks);
+		if (measurement_ns > 0) {
+			out << " (" << std::fixed << std::setprecision(1)
+				<< reset_ns / measurement_ns << "x the measurement)";
+		}
+		return out.str();
+	}
+
+	/* Compose a bootstrap interval of a tick count.
+	 * \param cal The calibration of the clock the ticks came from
+	 * \param interval The interval
+	 * \return the composed interval
+	 */
+	static std::string compose_interval(const ClockCalibration& cal,
+										const BootstrapInterval& interval)
+	{
+		return format(cal, interval.estimate) + " [" +
+			   format(cal, interval.low) + ", " + format(cal, interval.high) +
+			   "]";
+	}
+
+	/* Format a tick count in both raw ticks and wall time.
+	 * \param cal The calibration of the clock the ticks came from
+	 * \param ticks The tick count
+	 * \return the formatted tick count
+	 */
+	static std::string format(const ClockCalibration& cal, double ticks)
+	{
+		std::ostringstream out;
+		out << std::fixed << std::setprecision(2);
+		// Only the TSC has a tick unit distinct from wall time.
+		if (cal.source == ClockSource::tsc) {
+			out << ticks << " cycles (" << cal.to_ns(ticks) << " ns)";
+		} else {
+			out << cal.to_ns(ticks) << " ns";
+		}
+		return out.str();
+	}
+
+	/* Format a wall-clock duration in the largest fitting unit.
+	 * \param ns The duration in nanoseconds
+	 * \return the formatted duration
+	 */
+	static std::string format_ns(double ns)
+	{
+		static const char* units[] = {"ns", "us", "ms", "s"};
+		size_t unit = 0;
+		while (ns >= 1000 && unit < 3) {
+			ns /= 1000;
+			++unit;
+		}
+		std::ostringstream out;
+		out << std::fixed << std::setprecision(2) << ns << " " << units[unit];
+		return out.str();
+	}
+
+	/* Get a printable name for a verdict.
+	 * \param verdict The verdict
+	 * \return the name of the verdict
+	 */
+	static const char* verdict_name(BenchmarkVerdict verdict)
+	{
+		switch (verdict) {
+			case BenchmarkVerdict::draw:
+				return "draw";
+			case BenchmarkVerdict::win:
+				return "win";
+			case BenchmarkVerdict::loss:
+				return "loss";
+			case BenchmarkVerdict::questionable:
+				return "questionable";
+			default:
+				return "none";
+		}
+	}
 
+private:
+	std::vector<std::string> reports;
 };
 
-#endif // BENCHMARK_REPORT_HPP
\ No newline at end of file
+#endif  // BENCHMARK_REPORT_HPP
@@ -44,6 +44,27 @@
 #ifndef BENCHMARKRESULTS_HPP
 #define BENCHMARKRESULTS_HPP
 
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "goldilocks/affinity.hpp"
+#include "goldilocks/bootstrap.hpp"
+#include "goldilocks/clock.hpp"
+#include "goldilocks/hdr_histogram.hpp"
+#include "goldilocks/isolation.hpp"
+#include "goldilocks/modality.hpp"
+#include "goldilocks/perf_counters.hpp"
+#include "goldilocks/sequential_test.hpp"
+#include "goldilocks/statistics.hpp"
+#include "goldilocks/streaming_stats.hpp"
+#include "goldilocks/warmup.hpp"
 #include "report_base.hpp"
 
 enum class BenchmarkVerdict {
@@ -55,18 +76,77 @@ enum class BenchmarkVerdict {
 	win,
 	/// Comparative (Test B) wins
 	loss,
-	/// RSD too high, result is unreliable.
+	/// RSD too high (or below the clock's noise floor), result is unreliable.
 	questionable
 };
 
-class BenchmarkResult : public ReportBase
+/// How a BenchmarkResult stores its measurements.
+enum class SampleStorage {
+	/// Keep every sample. Exact statistics, but memory grows with the run.
+	raw,
+	/// Keep only running statistics. Constant memory, approximate quartiles.
+	streaming,
+	/** Keep an HDR histogram of each series. Fixed memory, with every
+	 * statistic (including tail percentiles) to a few significant figures.*/
+	histogram
+};
+
+/// What the verdict of a comparison is judged on.
+enum class Metric {
+	/// The time each run takes.
+	time,
+	/** The user-space instructions each run retires. They barely vary
+	 * from run to run, even on a busy machine, but they are blind to
+	 * stalls, cache misses and anything else that costs time alone.*/
+	instructions
+};
+
+/** Allocator for cache-line aligned storage, so that a series of
+ * samples never shares a cache line with anything else.*/
+template<typename T, std::size_t Align = 64> class AlignedAllocator
 {
-private:
-	BenchmarkVerdict verdict;
+public:
+	typedef T value_type;
+
+	template<typename U> struct rebind {
+		typedef AlignedAllocator<U, Align> other;
+	};
+
+	AlignedAllocator() = default;
+
+	template<typename U>
+	// cppcheck-suppress noExplicitConstructor
+	AlignedAllocator(const AlignedAllocator<U, Align>&)
+	{
+	}
+
+	T* allocate(std::size_t n)
+	{
+		return static_cast<T*>(
+			::operator new(n * sizeof(T), std::align_val_t(Align)));
+	}
+
+	void deallocate(T* p, std::size_t)
+	{
+		::operator delete(p, std::align_val_t(Align));
+	}
 
-	/// Vector to store the raw measurements
-	std::vector<uint64_t> results;
+	template<typename U> bool operator==(const AlignedAllocator<U, Align>&) const
+	{
+		return true;
+	}
 
+	template<typename U> bool operator!=(const AlignedAllocator<U, Align>&) const
+	{
+		return false;
+	}
+};
+
+/// The type we use for storing a series of raw measurements.
+typedef std::vector<uint64_t, AlignedAllocator<uint64_t>> samples_t;
+
+/// The summary statistics of one series of measurements.
+struct SeriesStats {
 	/// The accumulated count.
 	uint64_t acc = 0;
 
@@ -91,6 +171,15 @@ private:
 	/// The upper quartile value.
 	uint64_t q3 = 0;
 
+	/// The 99th percentile value.
+	uint64_t p99 = 0;
+
+	/// The 99.9th percentile value.
+	uint64_t p999 = 0;
+
+	/// The 99.99th percentile value.
+	uint64_t p9999 = 0;
+
 	/// The range.
 	uint64_t range = 0;
 
@@ -139,22 +228,641 @@ private:
 	/// The adjusted standard deviance
 	double std_dev_adj = 0;
 
-	/// The relative standard deviation (coefficient of variation)
-	uint8_t rsd = 0;
+	/// The relative standard deviation (coefficient of variation), in percent
+	double rsd = 0;
+
+	/// The adjusted relative standard deviation, in percent
+	double rsd_adj = 0;
+
+	/// The outlier policy the adjusted statistics were taken with.
+	OutlierPolicy outliers;
+
+	/// The lowest rank (from 0, in sorted order) of a retained sample.
+	uint64_t retained_first = 0;
+
+	/// The highest rank (from 0, in sorted order) of a retained sample.
+	uint64_t retained_last = 0;
+
+	/** The shape of the distribution, and its modes. Not available with
+	 * streaming storage, which keeps no distribution.*/
+	Modality modality;
+};
+
+/** The result of benchmarking a test (A) against a comparative (B).
+ * The measurements of each side are stored in their own contiguous
+ * array (structure-of-arrays), with sample i of each array taken as
+ * a pair.*/
+class BenchmarkResult : public ReportBase
+{
+private:
+	BenchmarkVerdict verdict;
+
+	/// How measurements are stored.
+	SampleStorage storage = SampleStorage::raw;
+
+	/// The raw measurements of the test (A).
+	samples_t samples_a;
+
+	/// The raw measurements of the comparative (B).
+	samples_t samples_b;
+
+	/// The running statistics of the test (A), when streaming.
+	StreamingStats stream_a;
+
+	/// The running statistics of the comparative (B), when streaming.
+	StreamingStats stream_b;
+
+	/** The running statistics of the paired differences, when streaming
+	 * or keeping histograms.*/
+	StreamingStats stream_diff;
+
+	/// The histogram of the test (A), when keeping histograms.
+	std::optional<HdrHistogram> hist_a;
+
+	/// The histogram of the comparative (B), when keeping histograms.
+	std::optional<HdrHistogram> hist_b;
+
+	/// The statistics of the test (A).
+	SeriesStats stats_a;
+
+	/// The statistics of the comparative (B).
+	SeriesStats stats_b;
+
+	/// The mean paired difference.
+	double diff_mean = 0;
+
+	/// The standard deviation of the paired differences.
+	double diff_std_dev = 0;
+
+	/// The hypothesis test to judge the verdict with.
+	VerdictMethod method = VerdictMethod::paired_t;
+
+	/// The significance level of the verdict.
+	double alpha = 0.05;
+
+	/// The adjusted RSD (in percent) above which a verdict is questionable.
+	double max_rsd = 50;
+
+	/// The outcome of the hypothesis test.
+	HypothesisTest comparison;
+
+	/// Which samples are outliers, to leave out of the adjusted statistics.
+	OutlierPolicy outlier_policy;
+
+	/// How many bootstrap resamples to take, or 0 for none.
+	uint32_t bootstrap_resamples = 0;
+
+	/// How many threads to bootstrap with, or 0 for one per core.
+	uint32_t bootstrap_threads = 0;
+
+	/// The seed for bootstrap resampling.
+	uint64_t bootstrap_seed = 0;
 
-	/// The adjusted relative standard deviation
-	uint8_t rsd_adj = 0;
+	/// The bootstrap confidence intervals.
+	BootstrapResult bootstrap;
+
+	/// How the test (A) warmed up.
+	WarmupResult warmup_a;
+
+	/// How the comparative (B) warmed up.
+	WarmupResult warmup_b;
+
+	/// What the pilot run found, if there was one.
+	PowerAdvice power_advice;
+
+	/// Why sampling stopped before the budget was used up, if it did.
+	EarlyStop early_stop = EarlyStop::none;
+
+	/// How many times sampling was checked for stopping early.
+	uint64_t early_stop_looks = 0;
+
+	/// How each measurement started from a clean state.
+	Reset reset = Reset::janitor;
+
+	/// The mean time spent resetting before each test (A) measurement.
+	double reset_ns_a = 0;
+
+	/// The mean time spent resetting before each comparative measurement.
+	double reset_ns_b = 0;
+
+	/// Where, and how, the benchmark's thread ran.
+	Placement placement;
+
+	/// Whether event counters, or allocation counts, were asked for.
+	bool counters_requested = false;
+
+	/// The counters that were collected, as a mask of counter_bit()s.
+	uint32_t counters = 0;
+
+	/// The events counted per run of the test (A), by counter.
+	std::array<StreamingStats, COUNTER_COUNT> counts_a;
+
+	/// The events counted per run of the comparative (B), by counter.
+	std::array<StreamingStats, COUNTER_COUNT> counts_b;
+
+	/// What the verdict was asked to be judged on.
+	Metric metric_requested = Metric::time;
+
+	/** What the verdict was judged on: time, when instructions were asked
+	 * for but couldn't be counted.*/
+	Metric metric = Metric::time;
+
+	/** The smallest difference in instructions, as a fraction of the
+	 * comparative's, that can win or lose.*/
+	double instruction_tolerance = 0.001;
+
+	/// The paired differences of the instructions counted per run.
+	StreamingStats instruction_diff;
+
+	/// The outcome of the hypothesis test on the instruction counts.
+	HypothesisTest instruction_comparison;
+
+	/// Whether the benchmark ran to completion.
+	Status status = Status::OK;
+
+	/// Why the benchmark failed, or empty if it didn't.
+	std::string failure;
+
+	/// How the clock ticks in this result relate to wall time.
+	ClockCalibration calibration;
+
+	/// The clock overhead that was subtracted from every measurement.
+	ClockOverhead overhead;
+
+	/** Whether either side's mean measurement, a whole batch of runs, is
+	 * within the noise of the clock overhead.*/
+	bool below_noise_floor = false;
+
+	/// How many runs of the test were timed in each measurement.
+	uint64_t batch_test = 1;
+
+	/// How many runs of the comparative were timed in each measurement.
+	uint64_t batch_comparative = 1;
+
+	/**Calculate the statistics of a single series. This reorders the
+	 * series, but doesn't fully sort it.
+	 * \param the series of measurements
+	 * \param [out] the statistics of the series
+	 * \param which samples are outliers
+	 */
+	static void
+		finalize_series(samples_t&, SeriesStats&, const OutlierPolicy&);
+
+	/**Fill in the statistics of a single series from running statistics.
+	 * Outliers were already judged, by the stream's own Tukey fences.
+	 * \param the running statistics of the series
+	 * \param [out] the statistics of the series
+	 */
+	static void finalize_stream(const StreamingStats&, SeriesStats&);
+
+	/**Fill in the statistics of a single series from its histogram.
+	 * \param the histogram of the series
+	 * \param [out] the statistics of the series
+	 * \param which samples are outliers
+	 */
+	static void finalize_histogram(const HdrHistogram&,
+								   SeriesStats&,
+								   const OutlierPolicy&);
+
+	/// Calculate the statistics of the paired differences.
+	void finalize_pairs();
+
+	/// Run the chosen hypothesis test on the finalized series.
+	void compare();
+
+	/** Judge the verdict on the instructions counted per run, rather than
+	 * on the time. Only the t-tests work from running statistics, so
+	 * Mann-Whitney U falls back to Welch's t-test here.*/
+	void judge_instructions();
+
+	friend class BenchmarkReport;
 
 public:
 	BenchmarkResult() : verdict(BenchmarkVerdict::none) {}
 
-	/**Convert a raw array of clock measurements into a complete
-	 * benchmark result. This does all of our statistical computations.
-	 * \param the BenchmarkResult instance of result A (1)
-	 * \param the BenchmarkResult instance of result B (2)
-	 * Calculate the final verdict based on adjusted results.
+	/**Choose how measurements are stored. Call before recording any.
+	 * \param the storage mode
+	 * \param the largest measurement a histogram tracks precisely
+	 * \param the significant figures a histogram preserves
+	 */
+	void set_storage(SampleStorage storage,
+					 uint64_t highest_trackable = HdrHistogram::DEFAULT_HIGHEST,
+					 uint8_t significant_figures =
+						 HdrHistogram::DEFAULT_SIGNIFICANT_FIGURES)
+	{
+		this->storage = storage;
+		if (storage == SampleStorage::histogram) {
+			this->hist_a.emplace(highest_trackable, significant_figures);
+			this->hist_b.emplace(highest_trackable, significant_figures);
+		} else {
+			this->hist_a.reset();
+			this->hist_b.reset();
+		}
+	}
+
+	/**Choose which samples count as outliers. Call before recording any.
+	 * Streaming storage judges outliers as samples arrive, and so only
+	 * supports Tukey's fences (or none); other policies fall back to
+	 * Tukey's default fences there.
+	 * \param the outlier policy
+	 * \throw std::invalid_argument if Tukey or MAD fences aren't a
+	 * positive, finite distance out, or the trim isn't a finite percentage
+	 */
+	void set_outlier_policy(const OutlierPolicy& policy)
+	{
+		if ((policy.method == OutlierMethod::tukey ||
+			 policy.method == OutlierMethod::mad) &&
+			!(policy.k > 0 && std::isfinite(policy.k))) {
+			throw std::invalid_argument("Outlier fences must be > 0 out");
+		}
+		if (policy.method == OutlierMethod::trim &&
+			!(policy.k >= 0 && std::isfinite(policy.k))) {
+			throw std::invalid_argument("Trim percentage must be >= 0");
+		}
+		this->outlier_policy = policy;
+		double fence_k = 1.5;
+		if (policy.method == OutlierMethod::tukey) {
+			fence_k = policy.k;
+		} else if (policy.method == OutlierMethod::none) {
+			fence_k = INFINITY;
+		}
+		this->stream_a = StreamingStats(fence_k);
+		this->stream_b = StreamingStats(fence_k);
+	}
+
+	/**Get how measurements are stored.
+	 * \return the storage mode
+	 */
+	SampleStorage get_storage() const { return this->storage; }
+
+	/**Reserve storage for measurements up front, so that recording them
+	 * doesn't reallocate in the middle of a run. Streaming storage never
+	 * needs to reserve anything.
+	 * \param the number of pairs of measurements to expect
 	 */
-	void finalize(const BenchmarkResult&, const BenchmarkResult&);
+	void reserve(uint64_t pairs)
+	{
+		if (this->storage == SampleStorage::raw) {
+			samples_a.reserve(pairs);
+			samples_b.reserve(pairs);
+		}
+	}
+
+	/**Choose how the verdict is judged. Call before finalize().
+	 * \param the hypothesis test to use. Mann-Whitney U needs raw storage,
+	 * and falls back to Welch's t-test otherwise.
+	 * \param the significance level, e.g. 0.05
+	 * \param the adjusted RSD (in percent) of either series above which
+	 * the verdict is questionable
+	 */
+	void set_verdict_method(VerdictMethod method,
+							double alpha = 0.05,
+							double max_rsd = 50)
+	{
+		this->method = method;
+		this->alpha = alpha;
+		this->max_rsd = max_rsd;
+	}
+
+	/**Choose whether to take bootstrap confidence intervals, which need
+	 * raw storage. Call before finalize().
+	 * \param the number of resamples, or 0 for none
+	 * \param the number of threads to use, or 0 for one per core
+	 * \param the seed for resampling
+	 */
+	void set_bootstrap(uint32_t resamples, uint32_t threads, uint64_t seed)
+	{
+		this->bootstrap_resamples = resamples;
+		this->bootstrap_threads = threads;
+		this->bootstrap_seed = seed;
+	}
+
+	/**Get the bootstrap confidence intervals, at the confidence level of
+	 * the verdict. Only meaningful after finalize().
+	 * \return the intervals, with no resamples if none were taken
+	 */
+	const BootstrapResult& get_bootstrap() const { return this->bootstrap; }
+
+	/**Record how each test warmed up.
+	 * \param how the test (A) warmed up
+	 * \param how the comparative (B) warmed up
+	 */
+	void set_warmup(const WarmupResult& test, const WarmupResult& comparative)
+	{
+		this->warmup_a = test;
+		this->warmup_b = comparative;
+	}
+
+	/// \return how the test (A) warmed up
+	const WarmupResult& get_test_warmup() const { return this->warmup_a; }
+
+	/// \return how the comparative (B) warmed up
+	const WarmupResult& get_comparative_warmup() const
+	{
+		return this->warmup_b;
+	}
+
+	/**Record what a pilot run found about the samples needed.
+	 * \param the advice from the pilot
+	 */
+	void set_power_advice(const PowerAdvice& advice)
+	{
+		this->power_advice = advice;
+	}
+
+	/**Get what the pilot run found about the samples needed.
+	 * \return the advice, with no pilot samples if there was no pilot
+	 */
+	const PowerAdvice& get_power_advice() const { return this->power_advice; }
+
+	/**Record that sampling stopped before the budget was used up.
+	 * \param why sampling stopped
+	 * \param how many times sampling was checked for stopping
+	 */
+	void set_early_stop(EarlyStop reason, uint64_t looks)
+	{
+		this->early_stop = reason;
+		this->early_stop_looks = looks;
+	}
+
+	/**Get why sampling stopped before the budget was used up.
+	 * \return the reason, or none if the whole budget was used
+	 */
+	EarlyStop get_early_stop() const { return this->early_stop; }
+
+	/**Get how many times sampling was checked for stopping early.
+	 * \return the number of checks
+	 */
+	uint64_t get_early_stop_looks() const { return this->early_stop_looks; }
+
+	/**Record what resetting cost before each measurement. It is not
+	 * part of the measurements, but it is part of the benchmark's time.
+	 * \param how each measurement started from a clean state
+	 * \param the mean reset time before each test (A) measurement, in ns
+	 * \param the mean reset time before each comparative measurement
+	 */
+	void set_reset_cost(Reset reset, double test_ns, double comparative_ns)
+	{
+		this->reset = reset;
+		this->reset_ns_a = test_ns;
+		this->reset_ns_b = comparative_ns;
+	}
+
+	/**Get how each measurement started from a clean state.
+	 * \return janitor, or snapshot
+	 */
+	Reset get_reset() const { return this->reset; }
+
+	/**Get the mean reset time before each test (A) measurement.
+	 * \return the time, in nanoseconds
+	 */
+	double get_test_reset_ns() const { return this->reset_ns_a; }
+
+	/**Get the mean reset time before each comparative measurement.
+	 * \return the time, in nanoseconds
+	 */
+	double get_comparative_reset_ns() const { return this->reset_ns_b; }
+
+	/**Record where, and how, the benchmark's thread ran.
+	 * \param the placement of the thread
+	 */
+	void set_placement(const Placement& placement)
+	{
+		this->placement = placement;
+	}
+
+	/**Get where, and how, the benchmark's thread ran.
+	 * \return the placement of the thread
+	 */
+	const Placement& get_placement() const { return this->placement; }
+
+	/**Record which event counters were collected.
+	 * \param whether counters (or allocation counts) were asked for
+	 * \param the counters collected, as a mask of counter_bit()s
+	 */
+	void set_counters(bool requested, uint32_t counters)
+	{
+		this->counters_requested = requested;
+		this->counters = counters;
+	}
+
+	/**Get which event counters were collected.
+	 * \return the counters, as a mask of counter_bit()s
+	 */
+	uint32_t get_counters() const { return this->counters; }
+
+	/**Choose what the verdict is judged on. Call before finalize().
+	 * Instructions need their counts added with add_counts(); without
+	 * them, the verdict falls back to time.
+	 * \param the metric
+	 * \param the smallest difference in instructions, as a fraction of
+	 * the comparative's, that can win or lose
+	 */
+	void set_metric(Metric metric, double instruction_tolerance = 0.001)
+	{
+		this->metric_requested = metric;
+		this->instruction_tolerance = instruction_tolerance;
+	}
+
+	/**Get what the verdict was judged on. Only meaningful after finalize().
+	 * \return the metric, which is time if instructions weren't counted
+	 */
+	Metric get_metric() const { return this->metric; }
+
+	/**Get the outcome of the hypothesis test on the instruction counts.
+	 * Only meaningful after finalize(), with the instructions metric.
+	 * \return the outcome of the test
+	 */
+	const HypothesisTest& get_instruction_comparison() const
+	{
+		return this->instruction_comparison;
+	}
+
+	/**Add the events counted around a pair of measurements. Counts that
+	 * weren't taken (NaN) are left out, rather than taken as zero.
+	 * \param the counts per run of the test (A)
+	 * \param the counts per run of the comparative (B)
+	 */
+	void add_counts(const CounterValues& counts_a,
+					const CounterValues& counts_b)
+	{
+		for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+			if (!std::isnan(counts_a[c])) {
+				this->counts_a[c].add(counts_a[c]);
+			}
+			if (!std::isnan(counts_b[c])) {
+				this->counts_b[c].add(counts_b[c]);
+			}
+		}
+		const size_t instructions = static_cast<size_t>(Counter::instructions);
+		if (!std::isnan(counts_a[instructions]) &&
+			!std::isnan(counts_b[instructions])) {
+			this->instruction_diff.add(counts_a[instructions] -
+									   counts_b[instructions]);
+		}
+	}
+
+	/**Get the statistics of an event counted per run of the test (A).
+	 * \param the counter
+	 * \return the statistics of its counts
+	 */
+	const StreamingStats& get_test_counts(Counter counter) const
+	{
+		return this->counts_a[static_cast<size_t>(counter)];
+	}
+
+	/**Get the statistics of an event counted per run of the comparative.
+	 * \param the counter
+	 * \return the statistics of its counts
+	 */
+	const StreamingStats& get_comparative_counts(Counter counter) const
+	{
+		return this->counts_b[static_cast<size_t>(counter)];
+	}
+
+	/**Record whether the benchmark ran to completion.
+	 * \param OK, or Fail if the benchmark couldn't finish
+	 * \param why it failed, if it did
+	 */
+	void set_status(Status status, std::string failure = std::string())
+	{
+		this->status = status;
+		this->failure = std::move(failure);
+	}
+
+	/**Get whether the benchmark ran to completion.
+	 * \return OK, or Fail if the benchmark couldn't finish
+	 */
+	Status get_status() const { return this->status; }
+
+	/**Get why the benchmark failed.
+	 * \return the reason, or empty if it didn't fail
+	 */
+	const std::string& get_failure() const { return this->failure; }
+
+	/**Get the outcome of the hypothesis test behind the verdict.
+	 * Only meaningful after finalize().
+	 * \return the outcome of the test
+	 */
+	const HypothesisTest& get_comparison() const { return this->comparison; }
+
+	/**Record how the measurements' clock ticks relate to wall time.
+	 * \param the calibration of the clock source used for measuring
+	 */
+	void set_calibration(const ClockCalibration& calibration)
+	{
+		this->calibration = calibration;
+	}
+
+	/**Get how the measurements' clock ticks relate to wall time.
+	 * \return the calibration of the clock source used for measuring
+	 */
+	const ClockCalibration& get_calibration() const
+	{
+		return this->calibration;
+	}
+
+	/**Record the clock overhead that was subtracted from the measurements.
+	 * \param the clock overhead
+	 */
+	void set_overhead(ClockOverhead overhead)
+	{
+		this->overhead = std::move(overhead);
+	}
+
+	/**Get the clock overhead that was subtracted from the measurements.
+	 * \return the clock overhead
+	 */
+	const ClockOverhead& get_overhead() const { return this->overhead; }
+
+	/**Check whether the measurements are too small to trust, because
+	 * either side's mean measurement (a whole batch of runs) is within
+	 * the noise of the clock overhead itself.
+	 * Only meaningful after finalize().
+	 * \return true if the result is below the noise floor, else false
+	 */
+	bool is_below_noise_floor() const { return this->below_noise_floor; }
+
+	/**Record how many runs were timed in each measurement. Measurements
+	 * are always stored as the time for a single run.
+	 * \param the batch size of the test
+	 * \param the batch size of the comparative
+	 */
+	void set_batch_sizes(uint64_t batch_test, uint64_t batch_comparative)
+	{
+		this->batch_test = batch_test;
+		this->batch_comparative = batch_comparative;
+	}
+
+	/**Get how many runs of the test were timed in each measurement.
+	 * \return the batch size of the test
+	 */
+	uint64_t get_batch_test() const { return this->batch_test; }
+
+	/**Get how many runs of the comparative were timed in each measurement.
+	 * \return the batch size of the comparative
+	 */
+	uint64_t get_batch_comparative() const { return this->batch_comparative; }
+
+	/**Get the histogram of the test (A), e.g. to merge or serialize it.
+	 * \return the histogram, or nullptr if not keeping histograms
+	 */
+	const HdrHistogram* get_test_histogram() const
+	{
+		return this->hist_a ? &*this->hist_a : nullptr;
+	}
+
+	/**Get the histogram of the comparative (B).
+	 * \return the histogram, or nullptr if not keeping histograms
+	 */
+	const HdrHistogram* get_comparative_histogram() const
+	{
+		return this->hist_b ? &*this->hist_b : nullptr;
+	}
+
+	/**Get the statistics of the test (A). Only meaningful after finalize().
+	 * \return the statistics of the test
+	 */
+	const SeriesStats& get_test_stats() const { return this->stats_a; }
+
+	/**Get the statistics of the comparative (B).
+	 * Only meaningful after finalize().
+	 * \return the statistics of the comparative
+	 */
+	const SeriesStats& get_comparative_stats() const { return this->stats_b; }
+
+	/**Get the verdict of the comparison. Only meaningful after finalize().
+	 * \return the verdict
+	 */
+	BenchmarkVerdict get_verdict() const { return this->verdict; }
+
+	/**Get the number of pairs of measurements recorded.
+	 * \return the number of pairs
+	 */
+	uint64_t size() const
+	{
+		switch (this->storage) {
+			case SampleStorage::streaming:
+				return this->stream_a.size();
+			case SampleStorage::histogram:
+				return this->stream_diff.size();
+			default:
+				return this->samples_a.size();
+		}
+	}
+
+	/**Convert a tick count from this result into nanoseconds.
+	 * \param the tick count (cycles, for the TSC)
+	 * \return the duration in nanoseconds
+	 */
+	double to_ns(double ticks) const { return this->calibration.to_ns(ticks); }
+
+	/**Convert the raw clock measurements into a complete benchmark
+	 * result. This does all of our statistical computations, for each
+	 * series and for the comparison between them, and calculates the
+	 * final verdict.
+	 */
+	void finalize();
 
 	/*Adds in two numbers, one for each result A or B
 	 * \param the clock measurement for result A
@@ -162,11 +870,28 @@ public:
 	 */
 	inline void add_measurement(uint64_t measurement_a, uint64_t measurement_b)
 	{
-		results.push_back(measurement_a);
-		results.push_back(measurement_b);
+		switch (this->storage) {
+			case SampleStorage::streaming:
+				stream_a.add(measurement_a);
+				stream_b.add(measurement_b);
+				break;
+			case SampleStorage::histogram:
+				hist_a->record(measurement_a);
+				hist_b->record(measurement_b);
+				break;
+			default:
+				samples_a.push_back(measurement_a);
+				samples_b.push_back(measurement_b);
+				return;
+		}
+		stream_diff.add(static_cast<double>(measurement_a) -
+						static_cast<double>(measurement_b));
 	}
 
-	~BenchmarkResult();
+	// Results are complete once finalized; there is nothing to lap.
+	void lap() override {}
+
+	~BenchmarkResult() = default;
 };
 
 #endif  // BENCHMARKRESULTS_HPP
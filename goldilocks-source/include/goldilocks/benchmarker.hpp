@@ -44,18 +44,19 @@
 #ifndef GOLDILOCKS_BENCHMARKER_HPP
 #define GOLDILOCKS_BENCHMARKER_HPP
 
+#include "goldilocks/run_budget.hpp"
 #include "goldilocks/test.hpp"
 
 class Benchmarker
 {
 protected:
 	Test* test;
-	uint16_t iterations;
+	RunBudget budget;
 
 public:
 	// cppcheck-suppress noExplicitConstructor
-	Benchmarker(Test* test, uint16_t iterations = 1)
-	: test(test), iterations(iterations)
+	Benchmarker(Test* test, RunBudget budget = RunBudget())
+	: test(test), budget(budget)
 	{
 	}
 
@@ -0,0 +1,121 @@
+/** Bootstrap [Goldilocks]
+ * Version: 2.0
+ *
+ * Bootstrap confidence intervals for benchmark results.
+ *
+ * Author(s): Wilfrantz DEDE, Manuel Mateo, Jason C. McDonald
+ */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_BOOTSTRAP_HPP
+#define GOLDILOCKS_BOOTSTRAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/// A statistic, and the bootstrap confidence interval around it.
+struct BootstrapInterval {
+	/// The statistic, taken on the original samples.
+	double estimate = 0;
+
+	/// The lower bound of the interval.
+	double low = 0;
+
+	/// The upper bound of the interval.
+	double high = 0;
+};
+
+/** Bootstrap (percentile) confidence intervals for a test (A) and a
+ * comparative (B). These make no assumption about the shape of the
+ * distributions, so they hold up for heavy-tailed timings where intervals
+ * built from the standard deviation don't.*/
+struct BootstrapResult {
+	/// The number of resamples taken, or 0 if none were.
+	uint32_t resamples = 0;
+
+	/// The confidence level of the intervals, e.g. 0.95.
+	double confidence = 0;
+
+	/// The mean of the test (A).
+	BootstrapInterval mean_a;
+
+	/// The mean of the comparative (B).
+	BootstrapInterval mean_b;
+
+	/// The median of the test (A).
+	BootstrapInterval median_a;
+
+	/// The median of the comparative (B).
+	BootstrapInterval median_b;
+
+	/// The ratio of the medians (A / B). Below 1 means the test is faster.
+	BootstrapInterval median_ratio;
+};
+
+/**Bootstrap confidence intervals for the means and medians of two
+ * series, and the ratio of their medians, resampling each series
+ * independently. The resamples are spread across threads, each with its
+ * own random generator, but the result only depends on the seed.
+ *
+ * Median resamples are drawn directly: the k-th smallest of a resample
+ * is the sample at the k-th smallest of n uniforms, which is Beta
+ * distributed. Mean resamples use Poisson(1) weights (the Poisson
+ * bootstrap), so that many resamples share one sequential pass.
+ *
+ * Only the ranks a resampled median can reach, within ten standard
+ * deviations of the middle, are sorted, and on a copy: the series are
+ * left as they are.
+ * \param the series A
+ * \param the size of A
+ * \param the series B
+ * \param the size of B
+ * \param the number of resamples to take
+ * \param the confidence level, e.g. 0.95
+ * \param the number of threads to use, or 0 for one per core
+ * \param the seed for the random generators
+ * \return the intervals
+ */
+BootstrapResult bootstrap_intervals(const uint64_t*,
+									size_t,
+									const uint64_t*,
+									size_t,
+									uint32_t,
+									double,
+									uint32_t = 0,
+									uint64_t = 0);
+
+#endif  // GOLDILOCKS_BOOTSTRAP_HPP
@@ -41,138 +41,333 @@
  * on how to contribute to our projects.
  */
 
+#ifndef GOLDILOCKS_CLOCK_HPP
+#define GOLDILOCKS_CLOCK_HPP
+
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <ctime>
+#include <vector>
 
 #include "goldilocks/test.hpp"
 
-// MACRO IF we are using a GCC-style compiler.
-// NOTE: We're assuming Intel/AMD. What about PowerPC and ARM?
-#if defined __GNUC__ || __MINGW32__ || __MINGW64__
+// MACRO IF we are using a GCC-style compiler on Intel/AMD, offer the TSC.
+// NOTE: What about PowerPC and ARM? They only get the portable sources.
+#if (defined __GNUC__ || __MINGW32__ || __MINGW64__) && \
+	(defined __x86_64__ || defined __i386__)
+#define GOLDILOCKS_HAS_TSC 1
+#else
+#define GOLDILOCKS_HAS_TSC 0
+#endif
 
-// If we're on a 64-bit system...
-#if defined __LP64__
+// MACRO IF the platform offers a raw (non-NTP-slewed) monotonic clock.
+#if defined CLOCK_MONOTONIC_RAW
+#define GOLDILOCKS_HAS_MONOTONIC_RAW 1
+#else
+#define GOLDILOCKS_HAS_MONOTONIC_RAW 0
+#endif
 
-inline void calibrate()
-{
-	/* According to Intel's documentation, we must "warms up"
-	 * the instruction cache that we'll be using for measurement,
-	 * to improve accuracy.*/
+/// The time sources a test can be clocked with.
+enum class ClockSource {
+	/// Select the best source available on this host at runtime.
+	automatic,
+	/// Serialized timestamp counter (lfence+rdtsc, rdtscp+lfence).
+	tsc,
+	/// clock_gettime(CLOCK_MONOTONIC_RAW), normally served by the vDSO.
+	monotonic_raw,
+	/// std::chrono::steady_clock. Always available, but the coarsest.
+	steady
+};
 
-	uint32_t low, high;
+/// How the tick rate of a clock source was determined.
+enum class CalibrationMethod {
+	/// Not calibrated yet.
+	none,
+	/// The source already counts nanoseconds.
+	native,
+	/// CPUID leaf 0x15 (TSC/crystal clock ratio).
+	cpuid_crystal,
+	/// CPUID leaf 0x16 (processor base frequency).
+	cpuid_base_frequency,
+	/// CPUID hypervisor leaf 0x40000010 (TSC frequency from the host).
+	hypervisor,
+	/// Timed against CLOCK_MONOTONIC_RAW.
+	measured
+};
 
-	/* Run the following commands three times to warm up the
-	instructions cache.*/
-	for (uint16_t i = 0; i < 3; i++) {
-		asm volatile("cpuid;"
-					 "rdtsc;"
-					 "mov %%edx, %0;"
-					 "mov %%eax, %1;"
-					 : "=r"(high), "=r"(low)::"%rax", "%rbx", "%rcx", "%rdx");
-
-		asm volatile("rdtsc;"
-					 "mov %%edx, %0;"
-					 "mov %%eax, %1;"
-					 : "=r"(high), "=r"(low)::"%rax", "%rbx", "%rcx", "%rdx");
+/// The relationship between a clock source's ticks and wall time.
+struct ClockCalibration {
+	/// The (resolved) clock source this calibration applies to.
+	ClockSource source = ClockSource::steady;
+	/// How the tick rate was determined.
+	CalibrationMethod method = CalibrationMethod::none;
+	/// Ticks per nanosecond. For the TSC, this is cycles per nanosecond.
+	double ticks_per_ns = 1.0;
+	/// Whether the TSC runs at a constant rate regardless of P-states.
+	bool constant_tsc = false;
+	/// Whether the TSC also keeps running in deep C-states.
+	bool invariant_tsc = false;
+
+	/**Convert a tick count to nanoseconds.
+	 * \param the tick count
+	 * \return the duration in nanoseconds
+	 */
+	double to_ns(double ticks) const { return ticks / ticks_per_ns; }
+
+	/**Convert nanoseconds to a tick count.
+	 * \param the duration in nanoseconds
+	 * \return the tick count
+	 */
+	double to_ticks(double ns) const { return ns * ticks_per_ns; }
+};
+
+/// The cost of measuring an empty region with a clock source.
+struct ClockOverhead {
+	/// The empty measurements, sorted ascending.
+	std::vector<uint64_t> samples;
+	/// The overhead subtracted from every measurement (median), in ticks.
+	uint64_t estimate = 0;
+	/// How far the overhead itself wanders (99th percentile - median).
+	uint64_t noise_floor = 0;
+
+	/**Remove the measurement overhead from a measurement.
+	 * \param the raw measurement, in ticks
+	 * \return the measurement without overhead, never below zero
+	 */
+	uint64_t subtract(uint64_t ticks) const
+	{
+		return (ticks > estimate) ? (ticks - estimate) : 0;
 	}
-}
+};
+
+/**Check whether a clock source can be used on this host. This checks
+ * both that support was compiled in and that the CPU/OS provides it.
+ * \param the clock source to check
+ * \return true if the source is usable, else false
+ */
+bool clock_source_available(ClockSource);
+
+/**Pick the lowest-overhead, usable clock source on this host.
+ * An invariant TSC is always taken when it is usable, and any other
+ * source must be clearly cheaper than the preferred one to replace it,
+ * so the choice doesn't change from run to run. The selection is made
+ * once and cached for the life of the process.
+ * \return the selected clock source (never ClockSource::automatic)
+ */
+ClockSource select_clock_source();
 
-inline uint64_t clock(Test* test = 0)
+/**Determine the tick rate of a clock source. The TSC is calibrated
+ * from CPUID where the CPU reports its frequency, or else timed against
+ * CLOCK_MONOTONIC_RAW; this is only done once per process.
+ * All other sources already count nanoseconds.
+ * \param the clock source to calibrate (resolved if automatic)
+ * \return the calibration for the resolved clock source
+ */
+ClockCalibration calibrate_clock(ClockSource = ClockSource::automatic);
+
+/**Get a printable name for a clock source.
+ * \param the clock source
+ * \return the name of the clock source
+ */
+const char* clock_source_name(ClockSource);
+
+/**Resolve ClockSource::automatic (or an unavailable source) to a
+ * concrete, usable clock source.
+ * \param the requested clock source
+ * \return the clock source that will actually be used
+ */
+ClockSource resolve_clock_source(ClockSource);
+
+#if GOLDILOCKS_HAS_TSC
+
+/**Read the timestamp counter at the START of a measurement.
+ * The lfence keeps rdtsc from executing before all prior instructions
+ * have completed, without the unpredictable cost of cpuid.
+ * \return the current timestamp counter
+ */
+inline uint64_t tsc_start()
 {
 	uint32_t low, high;
-	uint64_t cyc1, cyc2;
-
-	// Serialize initially (we won't do it later, though.)
-	asm volatile("cpuid;" ::: "%rax", "%rbx", "%rcx", "%rdx");
-	// Get the initial timestamp (all 64 bits).
-	asm volatile("rdtsc;"
-				 "mov %%edx, %0;"
-				 "mov %%eax, %1;"
-				 : "=r"(high), "=r"(low)::"%rax", "%rdx");
-	// Put the high and low halves of the timestamp together and store.
-	cyc1 = ((uint64_t)high << 32) | low;
+	asm volatile("lfence;"
+				 "rdtsc;"
+				 : "=a"(low), "=d"(high)::"memory");
+	// Put the high and low halves of the timestamp together.
+	return ((uint64_t)high << 32) | low;
+}
 
-	/* If we have a test, run it. (If there is no test, we will just
-	 * wind up measuring the measurement instructions by themselves.*/
-	if (test != NULL) {
-		test->run_optimized();
-	}
+/**Read the timestamp counter at the END of a measurement.
+ * rdtscp waits for all prior instructions to retire before reading,
+ * and the trailing lfence keeps later instructions from starting early.
+ * \return the current timestamp counter
+ */
+inline uint64_t tsc_stop()
+{
+	uint32_t low, high, aux;
+	asm volatile("rdtscp;"
+				 "lfence;"
+				 : "=a"(low), "=d"(high), "=c"(aux)::"memory");
+	// Put the high and low halves of the timestamp together.
+	return ((uint64_t)high << 32) | low;
+}
 
-	/* Get the second timestamp. DO NOT SERIALIZE! The CPUID instruction
-	 * is too unpredictable in terms of execution size. We can just
-	 * assume that an out-of-order execution will yield an outlier
-	 * measurement.*/
-	asm volatile(/*"cpuid;"*/
-				 "rdtsc;"
-				 "mov %%edx, %0;"
-				 "mov %%eax, %1;"
-				 : "=r"(high), "=r"(low)::"%rax", "%rdx");
+#endif
 
-	// Put the high and low halves of the timestamp together and store.
-	cyc2 = ((uint64_t)high << 32) | low;
+/**Read CLOCK_MONOTONIC_RAW in nanoseconds.
+ * Falls back to steady_clock where the raw clock does not exist.
+ * \return the current time in nanoseconds
+ */
+inline uint64_t monotonic_raw_now()
+{
+#if GOLDILOCKS_HAS_MONOTONIC_RAW
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			   std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+#endif
+}
 
-	// Return the difference between the AFTER and BEFORE timestamps.
-	return (cyc2 - cyc1);
+/**Read std::chrono::steady_clock in nanoseconds.
+ * \return the current time in nanoseconds
+ */
+inline uint64_t steady_now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			   std::chrono::steady_clock::now().time_since_epoch())
+		.count();
 }
 
-// If we're on a 32-bit system...
-#else
+/**Read the start timestamp for the given source.
+ * Each specialization must be usable on the current host.*/
+template<ClockSource S> inline uint64_t clock_start();
+
+/**Read the stop timestamp for the given source.
+ * Each specialization must be usable on the current host.*/
+template<ClockSource S> inline uint64_t clock_stop();
 
-/* See the comments for the 64-bit versions of these functions. The only
- * difference between the 32-bit and 64-bit versions is in which
- * registers we are clobbering. On x86 (32-bit), we clobber %eax-%edx,
- * while on x64, we clobber %rax-%rdx.*/
-inline void calibrate()
+#if GOLDILOCKS_HAS_TSC
+template<> inline uint64_t clock_start<ClockSource::tsc>()
 {
-	uint32_t low, high;
+	return tsc_start();
+}
 
-	for (uint16_t i = 0; i < 3; i++) {
-		asm volatile("cpuid;"
-					 "rdtsc;"
-					 "mov %%edx, %0;"
-					 "mov %%eax, %1;"
-					 : "=r"(high), "=r"(low)::"%eax", "%ebx", "%ecx", "%edx");
-
-		asm volatile("rdtsc;"
-					 "mov %%edx, %0;"
-					 "mov %%eax, %1;"
-					 : "=r"(high), "=r"(low)::"%eax", "%ebx", "%ecx", "%edx");
-	}
+template<> inline uint64_t clock_stop<ClockSource::tsc>() { return tsc_stop(); }
+#endif
+
+template<> inline uint64_t clock_start<ClockSource::monotonic_raw>()
+{
+	return monotonic_raw_now();
 }
 
-inline uint64_t clock(Test* test = 0)
+template<> inline uint64_t clock_stop<ClockSource::monotonic_raw>()
 {
-	uint32_t low, high;
-	uint64_t cyc1, cyc2;
-
-	asm volatile("cpuid;" ::: "%eax", "%ebx", "%ecx", "%edx");
-	asm volatile("rdtsc;"
-				 "mov %%edx, %0;"
-				 "mov %%eax, %1;"
-				 : "=r"(high), "=r"(low)::"%eax", "%edx");
-	cyc1 = ((uint64_t)high << 32) | low;
-	if (test != NULL) {
-		test->run_optimized();
+	return monotonic_raw_now();
+}
+
+template<> inline uint64_t clock_start<ClockSource::steady>()
+{
+	return steady_now();
+}
+
+template<> inline uint64_t clock_stop<ClockSource::steady>()
+{
+	return steady_now();
+}
+
+/**Clock a batch of runs of a test with a fixed clock source.
+ * The source is a template parameter so that nothing but the
+ * timestamp reads themselves land inside the measured region.
+ * \param the test to run, or nullptr to measure the clock alone
+ * \param the number of times to run the test inside the measurement
+ * \return the elapsed ticks of the clock source
+ */
+template<ClockSource S>
+inline uint64_t clock_with(Test* test, uint64_t batch = 1)
+{
+	// Get the initial timestamp.
+	uint64_t start = clock_start<S>();
+
+	/* If we have a test, run it. (If there is no test, we will just
+	 * wind up measuring the measurement instructions by themselves.*/
+	if (test != nullptr) {
+		for (uint64_t i = 0; i < batch; ++i) {
+			test->run_optimized();
+		}
 	}
-	asm volatile(/*"cpuid;"*/
-				 "rdtsc;"
-				 "mov %%edx, %0;"
-				 "mov %%eax, %1;"
-				 : "=r"(high), "=r"(low)::"%eax", "%edx");
 
-	cyc2 = ((uint64_t)high << 32) | low;
+	// Get the second timestamp.
+	uint64_t stop = clock_stop<S>();
 
-	return (cyc2 - cyc1);
+	// Return the difference between the AFTER and BEFORE timestamps.
+	return (stop - start);
 }
+
+/**Clock a single run (or a batch of runs) of a test.
+ * Ticks are CPU cycles for ClockSource::tsc, and nanoseconds for
+ * every other source.
+ * \param the test to run, or nullptr to measure the clock alone
+ * \param the clock source to use (resolved if automatic)
+ * \param the number of times to run the test inside the measurement
+ * \return the elapsed ticks of the clock source, for the whole batch
+ */
+inline uint64_t clock(Test* test = nullptr,
+					  ClockSource source = ClockSource::automatic,
+					  uint64_t batch = 1)
+{
+	// Dispatch here, so the choice of source is not part of the measurement.
+	switch (resolve_clock_source(source)) {
+#if GOLDILOCKS_HAS_TSC
+		case ClockSource::tsc:
+			return clock_with<ClockSource::tsc>(test, batch);
 #endif
+		case ClockSource::monotonic_raw:
+			return clock_with<ClockSource::monotonic_raw>(test, batch);
+		default:
+			return clock_with<ClockSource::steady>(test, batch);
+	}
+}
 
-/* MACRO ELSE if we're not on a GCC, just don't offer the rdtsc functions;
- * offer dummies instead. We will NOT be supporting MSVC under ANY
- * circumstances!*/
-#else
+/**Warm up the instruction cache used by the clock source, then
+ * measure the overhead of the measurement instructions by themselves.
+ * According to Intel's documentation, we must "warm up" the
+ * instruction cache that we'll be using for measurement,
+ * to improve accuracy.
+ * \param the clock source to calibrate (resolved if automatic)
+ * \param the number of empty measurements to take
+ * \return the overhead of the clock source
+ */
+inline ClockOverhead calibrate(ClockSource source = ClockSource::automatic,
+							   uint32_t samples = 1000)
+{
+	source = resolve_clock_source(source);
 
-// TODO Non-GCC clock functions.
-inline void calibrate() { return; }
+	// Run the measurement three times to warm up the instruction cache.
+	for (uint16_t i = 0; i < 3; i++) {
+		clock(nullptr, source);
+	}
 
-inline uint64_t clock(Test* test = 0) { return; }
+	ClockOverhead overhead;
+	if (samples == 0) {
+		return overhead;
+	}
 
-#endif
+	// Measure the measurement instructions by themselves.
+	overhead.samples.reserve(samples);
+	for (uint32_t i = 0; i < samples; i++) {
+		overhead.samples.push_back(clock(nullptr, source));
+	}
+	std::sort(overhead.samples.begin(), overhead.samples.end());
+
+	/* Use the median, not the mean: an interrupt during one empty
+	 * measurement would otherwise inflate the overhead we subtract.*/
+	overhead.estimate = overhead.samples[samples / 2];
+	overhead.noise_floor =
+		overhead.samples[(samples - 1) * 99 / 100] - overhead.estimate;
+
+	return overhead;
+}
+
+#endif  // GOLDILOCKS_CLOCK_HPP
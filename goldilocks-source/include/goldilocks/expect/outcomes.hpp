@@ -48,6 +48,7 @@
 #include <string>     // std::to_string
 #include <tuple>      // std::tuple
 
+#include "goldilocks/alloc_tracker.hpp"
 #include "goldilocks/expect/should.hpp"
 #include "goldilocks/types.hpp"
 #include "iosqueak/stringify.hpp"
@@ -288,4 +289,96 @@ inline FuncOutcomePtr build_funcoutcome(const bool& passed,
 														args...);
 }
 
+/// Outcome of evaluation for Expect<That::AllocatesAtMost> and
+/// Expect<That::DoesNotAllocate>.
+template<typename... Args> class AllocOutcome : public AbstractOutcome
+{
+protected:
+	/// What the function allocated.
+	AllocCounts allocated;
+	/// The most allocations expected.
+	uint64_t limit;
+	/// Whether allocations were counted at all.
+	bool tracked;
+	// The name of the function as a string.
+	const char* name_hint;
+	// The arguments to passed to the function.
+	std::tuple<Args...> args;
+
+public:
+	/** Create a new outcome.
+	 * \param passed: the raw outcome of the comparison as a boolean
+	 * \param allocated: what the function allocated
+	 * \param limit: the most allocations expected
+	 * \param tracked: whether allocations were counted at all
+	 * \param name_hint: the name of the of the function as a string
+	 * \param args: The arguments passed to the function
+	 * \return an outcome object
+	 */
+	AllocOutcome<Args...>(const bool& passed,
+						  const AllocCounts& allocated,
+						  const uint64_t& limit,
+						  const bool& tracked,
+						  const char* name_hint,
+						  Args... args)
+	: AbstractOutcome(passed), allocated(allocated), limit(limit),
+	  tracked(tracked), name_hint(name_hint), args(std::make_tuple(args...))
+	{
+	}
+
+	/** Create the string representation of the outcome.
+	 * \param should: how success should be interpreted.
+	 * \param comparison: the string representing the comparison operation
+	 */
+	testdoc_t compose(const Should& should,
+					  const testdoc_t comparison) const override
+	{
+		// Create the appropriate outcome representation string.
+		testdoc_t outcome = compose_outcome(should);
+
+		if (outcome == "") {
+			return "";
+		}
+
+		const testdoc_t call = stringify(this->name_hint) + "(" +
+							   stringify(this->args) + ")" + comparison +
+							   std::to_string(this->limit) + ": ";
+		if (!this->tracked) {
+			return call + "allocations aren't tracked in this build" +
+				   outcome;
+		}
+		// Report what was allocated, whether or not it was too much.
+		return call + std::to_string(this->allocated.allocations) +
+			   " allocations (" + std::to_string(this->allocated.bytes) +
+			   " bytes)" + outcome;
+	}
+
+	~AllocOutcome() = default;
+};
+
+/** Build an allocation outcome.
+ * \param passed: the raw outcome of the comparison as a boolean
+ * \param allocated: what the function allocated
+ * \param limit: the most allocations expected
+ * \param tracked: whether allocations were counted at all
+ * \param name_hint: the name of the of the function as a string
+ * \param args: The arguments passed to the function
+ * \return a shared pointer to the outcome.
+ */
+template<typename... Args>
+inline OutcomePtr build_allocoutcome(const bool& passed,
+									 const AllocCounts& allocated,
+									 const uint64_t& limit,
+									 const bool& tracked,
+									 const char* name_hint,
+									 const Args... args)
+{
+	return std::make_shared<AllocOutcome<Args...>>(passed,
+												   allocated,
+												   limit,
+												   tracked,
+												   name_hint,
+												   args...);
+}
+
 #endif
@@ -53,7 +53,7 @@ enum class Should { Pass, Pass_Silent, Fail, Fail_Silent };
  * \param should: the Should value to convert
  * \return a string representing the Should value.
  */
-std::string stringify(const Should& should)
+inline std::string stringify(const Should& should)
 {
 	/* This function is here to provide stringify() support less expensively
 	 * than overloading operator<<.
@@ -623,6 +623,73 @@ struct FuncThrows {
 	}
 };
 
+/** Check that a function allocates on the heap no more than a given
+ * number of times. Only the calling thread's allocations are counted, and
+ * only if the library was built to track them; otherwise, this fails
+ * without calling the function.*/
+struct AllocatesAtMost {
+	/// The string representation of the comparison taking place.
+	static constexpr auto str{" allocates at most "};
+
+	/** Performs the evaluation.
+	 * \param limit: the most allocations expected
+	 * \param name_hint: the name of the function as a string, which is
+	 * needed for representing the outcome as a human-readable string.
+	 * \param func: the function to execute
+	 * \param args: the arguments to pass to the function
+	 * \return the outcome
+	 */
+	template<typename U, typename... Args>
+	static OutcomePtr eval(const uint64_t& limit,
+						   const char* name_hint,
+						   const U func,
+						   const Args... args)
+	{
+		// Nothing can be counted unless the library was built to track.
+		if (!AllocTracker::enabled()) {
+			return build_allocoutcome(
+				false, AllocCounts(), limit, false, name_hint, args...);
+		}
+		const AllocCounts mark = AllocTracker::start();
+		try {
+			func(args...);
+		} catch (...) {
+			// Don't leave the thread tracking.
+			AllocTracker::stop(mark);
+			throw;
+		}
+		const AllocCounts allocated = AllocTracker::stop(mark);
+		return build_allocoutcome(allocated.allocations <= limit,
+								  allocated,
+								  limit,
+								  true,
+								  name_hint,
+								  args...);
+	}
+};
+
+/** Check that a function never allocates on the heap. Only the calling
+ * thread's allocations are counted.*/
+struct DoesNotAllocate {
+	/// The string representation of the comparison taking place.
+	static constexpr auto str{" allocates at most "};
+
+	/** Performs the evaluation.
+	 * \param name_hint: the name of the function as a string, which is
+	 * needed for representing the outcome as a human-readable string.
+	 * \param func: the function to execute
+	 * \param args: the arguments to pass to the function
+	 * \return the outcome
+	 */
+	template<typename U, typename... Args>
+	static OutcomePtr eval(const char* name_hint,
+						   const U func,
+						   const Args... args)
+	{
+		return AllocatesAtMost::eval(0, name_hint, func, args...);
+	}
+};
+
 // Expects value to be in the inclusive range defined by lower and upper.
 struct IsInRange {
 	/// The string representation of the comparison taking place.
@@ -0,0 +1,259 @@
+/** HDR Histogram [Goldilocks]
+ * Version: 2.0
+ *
+ * Fixed-memory, high-dynamic-range histogram of benchmark samples.
+ *
+ * Author(s): Wilfrantz DEDE, Manuel Mateo, Jason C. McDonald
+ */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_HDR_HISTOGRAM_HPP
+#define GOLDILOCKS_HDR_HISTOGRAM_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** A high-dynamic-range histogram of unsigned samples.
+ *
+ * Values are sorted into logarithmic buckets, each split into linear
+ * sub-buckets, so that every value is recorded to within a fixed number
+ * of significant figures across the whole range. Memory is fixed when the
+ * histogram is created, recording is constant-time, and two histograms
+ * with the same configuration can be merged (e.g. across threads or runs).
+ */
+class HdrHistogram
+{
+public:
+	/// The default largest value tracked precisely (2^40 ticks).
+	static constexpr uint64_t DEFAULT_HIGHEST = 1ULL << 40;
+
+	/// The default number of significant figures.
+	static constexpr uint8_t DEFAULT_SIGNIFICANT_FIGURES = 3;
+
+protected:
+	/// The largest value tracked precisely. Larger values are clamped.
+	uint64_t highest_trackable;
+
+	/// The number of significant decimal figures to preserve (1-5).
+	uint8_t significant_figures;
+
+	/// log2 of half the number of sub-buckets per bucket.
+	uint32_t sub_bucket_half_count_magnitude = 0;
+
+	/// Half the number of sub-buckets per bucket.
+	uint64_t sub_bucket_half_count = 0;
+
+	/// Mask of the bits that select a sub-bucket.
+	uint64_t sub_bucket_mask = 0;
+
+	/// The number of logarithmic buckets.
+	uint32_t bucket_count = 0;
+
+	/// The count of samples in each sub-bucket.
+	std::vector<uint64_t> counts;
+
+	/// The total number of samples recorded.
+	uint64_t total = 0;
+
+	/// The number of samples clamped to highest_trackable.
+	uint64_t clamped = 0;
+
+	/// The smallest sample recorded (exact).
+	uint64_t min_val = UINT64_MAX;
+
+	/// The largest sample recorded (exact, even if clamped in the counts).
+	uint64_t max_val = 0;
+
+	/**Find the bucket a value falls in.
+	 * \param the value
+	 * \return the bucket index
+	 */
+	uint32_t bucket_index(uint64_t value) const
+	{
+		// Position of the highest set bit, counting the sub-bucket bits.
+		uint32_t pow2ceiling =
+			64 - __builtin_clzll(value | this->sub_bucket_mask);
+		return pow2ceiling - (this->sub_bucket_half_count_magnitude + 1);
+	}
+
+	/**Find the position in counts a value falls in.
+	 * \param the value
+	 * \return the index into counts
+	 */
+	size_t counts_index(uint64_t value) const
+	{
+		uint32_t bucket = this->bucket_index(value);
+		uint64_t sub_bucket = value >> bucket;
+		return ((size_t)(bucket + 1) << this->sub_bucket_half_count_magnitude) +
+			   (sub_bucket - this->sub_bucket_half_count);
+	}
+
+	/**Find the lowest value that falls in a position in counts.
+	 * \param the index into counts
+	 * \return the lowest value recorded at that index
+	 */
+	uint64_t value_at_index(size_t index) const;
+
+	/**Find the width of the range of values that are recorded
+	 * the same as a value.
+	 * \param the value
+	 * \return the size of the equivalent range
+	 */
+	uint64_t equivalent_range(uint64_t value) const;
+
+public:
+	/* Ctor
+	 * \param highest_trackable The largest value to track precisely
+	 * \param significant_figures Decimal figures to preserve, from 1 to 5
+	 * \throw std::invalid_argument if either parameter is out of range
+	 */
+	explicit HdrHistogram(uint64_t highest_trackable = DEFAULT_HIGHEST,
+						  uint8_t significant_figures =
+							  DEFAULT_SIGNIFICANT_FIGURES);
+
+	/**Record a sample.
+	 * \param the sample
+	 */
+	void record(uint64_t value)
+	{
+		if (value < this->min_val) {
+			this->min_val = value;
+		}
+		if (value > this->max_val) {
+			this->max_val = value;
+		}
+		if (value > this->highest_trackable) {
+			++this->clamped;
+			value = this->highest_trackable;
+		}
+		++this->counts[this->counts_index(value)];
+		++this->total;
+	}
+
+	/**Add every sample from another histogram into this one.
+	 * \param the histogram to merge in
+	 * \throw std::invalid_argument if the histograms are configured
+	 * differently
+	 */
+	void merge(const HdrHistogram&);
+
+	/// Forget every sample recorded.
+	void reset();
+
+	/**Get the value at a percentile. The value is reported as the highest
+	 * value equivalent (to the configured precision) to the real one.
+	 * \param the percentile, from 0 to 100
+	 * \return the value at that percentile, or 0 if there are no samples
+	 */
+	uint64_t percentile(double) const;
+
+	/**Count the samples in a range of values, inclusive. The range is
+	 * widened to the configured precision.
+	 * \param the lowest value
+	 * \param the highest value
+	 * \return the number of samples in the range
+	 */
+	uint64_t count_between(uint64_t, uint64_t) const;
+
+	/**Calculate the mean and standard deviation of the samples in a
+	 * range of values, inclusive, to the configured precision.
+	 * \param the lowest value
+	 * \param the highest value
+	 * \param [out] the mean
+	 * \param [out] the sample standard deviation
+	 * \return the number of samples in the range
+	 */
+	uint64_t moments_between(uint64_t, uint64_t, double&, double&) const;
+
+	/**Visit every non-empty sub-bucket, in order of value. Each stands
+	 * in for its midpoint, as in moments_between().
+	 * \param the function to call with each midpoint and its count
+	 */
+	template<typename Fn> void for_each_bucket(Fn fn) const
+	{
+		for (size_t i = 0; i < this->counts.size(); ++i) {
+			if (this->counts[i] == 0) {
+				continue;
+			}
+			const uint64_t lowest = this->value_at_index(i);
+			fn(lowest + (this->equivalent_range(lowest) - 1) / 2.0,
+			   this->counts[i]);
+		}
+	}
+
+	/// \return the number of samples recorded
+	uint64_t size() const { return this->total; }
+
+	/// \return the number of samples larger than highest_trackable
+	uint64_t size_clamped() const { return this->clamped; }
+
+	/// \return the smallest sample recorded, or 0 if there are none
+	uint64_t min() const { return (this->total > 0) ? this->min_val : 0; }
+
+	/// \return the largest sample recorded
+	uint64_t max() const { return this->max_val; }
+
+	/// \return the largest value tracked precisely
+	uint64_t get_highest_trackable() const
+	{
+		return this->highest_trackable;
+	}
+
+	/// \return the number of significant figures preserved
+	uint8_t get_significant_figures() const
+	{
+		return this->significant_figures;
+	}
+
+	/**Serialize the histogram to a compact byte string. Runs of empty
+	 * sub-buckets are run-length encoded and counts are stored as
+	 * variable-length integers, so sparse histograms stay small.
+	 * \return the serialized histogram
+	 */
+	std::string serialize() const;
+
+	/**Rebuild a histogram from serialize().
+	 * \param the serialized histogram
+	 * \return the histogram
+	 * \throw std::invalid_argument if the data is malformed, or holds
+	 * fewer or more samples than the histogram it came from
+	 */
+	static HdrHistogram deserialize(const std::string&);
+};
+
+#endif  // GOLDILOCKS_HDR_HISTOGRAM_HPP
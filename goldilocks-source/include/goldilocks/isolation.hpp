@@ -0,0 +1,205 @@
+/** Isolation [Goldilocks]
+ * Version: 2.0
+ *
+ * Runs benchmarks in child processes, and streams their samples back.
+ *
+ * Author(s): Wilfrantz DEDE, Manuel Mateo, Jason C. McDonald
+ */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_ISOLATION_HPP
+#define GOLDILOCKS_ISOLATION_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+// MACRO IF the platform can fork child processes and talk to them by pipe.
+#if defined __unix__ || defined __APPLE__
+#define GOLDILOCKS_HAS_FORK 1
+#include <sys/types.h>
+#else
+#define GOLDILOCKS_HAS_FORK 0
+typedef int pid_t;
+#endif
+
+/// Where a benchmark runs, relative to the runner.
+enum class Isolation {
+	/// In the runner's own process, alongside everything run before it.
+	none,
+	/// In a fresh child process for the whole benchmark.
+	benchmark,
+	/** In a fresh child process for each side (test and comparative),
+	 * run at the same time. Pairs are matched by index, but no longer
+	 * share a moment on the same core, so the paired t-test is weaker
+	 * evidence than usual; prefer Welch's t-test or Mann-Whitney U.*/
+	side
+};
+
+/// How each measurement starts from a clean state.
+enum class Reset {
+	/// By calling the test's janitor() before it.
+	janitor,
+	/** By taking it in a copy-on-write child process, forked after pre(),
+	 * so it starts from a pristine copy of the fixture. janitor() is never
+	 * called. Pages the test writes are copied on first touch, and that
+	 * cost is part of the measurement.*/
+	snapshot
+};
+
+/** Writes tagged, length-prefixed records to a pipe, in blocks, so that
+ * streaming samples doesn't cost a system call each.*/
+class PipeWriter
+{
+protected:
+	/// The pipe to write to.
+	int fd;
+
+	/// The records not yet written.
+	std::vector<char> buffer;
+
+	/// How many bytes to collect before writing.
+	static constexpr size_t BLOCK = 1 << 16;
+
+public:
+	/* Ctor
+	 * \param fd The write end of the pipe
+	 */
+	explicit PipeWriter(int fd);
+
+	/**Queue a record, writing the queue out if it is full.
+	 * \param the tag of the record
+	 * \param the record, which must be trivially copyable
+	 */
+	template<typename T> void write(char tag, const T& record)
+	{
+		const uint32_t size = sizeof(T);
+		const size_t at = this->buffer.size();
+		this->buffer.resize(at + 1 + sizeof(size) + size);
+		this->buffer[at] = tag;
+		memcpy(&this->buffer[at + 1], &size, sizeof(size));
+		memcpy(&this->buffer[at + 1 + sizeof(size)], &record, size);
+		if (this->buffer.size() >= BLOCK) {
+			this->flush();
+		}
+	}
+
+	/**Write out every queued record.
+	 * \return true if written, false if the pipe is broken
+	 */
+	bool flush();
+
+	~PipeWriter() { this->flush(); }
+};
+
+/**Decode a record written by PipeWriter.
+ * \param the payload of the record
+ * \param [out] the record
+ * \return true if the payload was the right size, else false
+ */
+template<typename T> bool read_record(const std::string& payload, T& record)
+{
+	if (payload.size() != sizeof(T)) {
+		return false;
+	}
+	memcpy(&record, payload.data(), sizeof(T));
+	return true;
+}
+
+/// How a child process ended.
+struct ChildExit {
+	/// Whether the child exited cleanly.
+	bool succeeded = false;
+
+	/// Why the child failed, or empty if it didn't.
+	std::string reason;
+};
+
+/** A child process that runs part of a benchmark and writes its records
+ * back to us through a pipe.*/
+class ChildProcess
+{
+protected:
+	/// The child's process ID, or -1 if it isn't running.
+	pid_t pid = -1;
+
+	/// The read end of the pipe from the child, or -1 once closed.
+	int fd = -1;
+
+	/// Bytes read from the child that don't yet make a whole record.
+	std::string pending;
+
+	/// Whether the child was killed for taking too long.
+	bool timed_out = false;
+
+public:
+	ChildProcess() = default;
+	ChildProcess(const ChildProcess&) = delete;
+	ChildProcess& operator=(const ChildProcess&) = delete;
+
+	/**Fork a child process that runs a function and exits.
+	 * \param the function to run in the child, given the write end of
+	 * the pipe; it returns the child's exit code
+	 * \param the CPU to pin the child to, or -1 to leave it be
+	 * \return true if the child started, else false
+	 */
+	bool spawn(const std::function<int(int)>&, int = -1);
+
+	/**Read every record the child writes, until it closes the pipe.
+	 * \param the children to read from
+	 * \param the most time to wait, in nanoseconds, or 0 for no limit;
+	 * children still running then are killed
+	 * \param the function to call with the child's index, and each
+	 * record's tag and payload
+	 * \return true if every child finished in time, else false
+	 */
+	static bool
+		read_all(std::vector<ChildProcess*>&,
+				 uint64_t,
+				 const std::function<void(size_t, char, const std::string&)>&);
+
+	/**Wait for the child to exit, and find out how it ended.
+	 * \return how the child ended
+	 */
+	ChildExit wait();
+
+	~ChildProcess();
+};
+
+#endif  // GOLDILOCKS_ISOLATION_HPP
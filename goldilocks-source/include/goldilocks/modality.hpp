@@ -0,0 +1,111 @@
+/** Modality [Goldilocks]
+ * Version: 2.0
+ *
+ * Detects the modes in the distribution of a series of measurements.
+ *
+ * Author(s): Wilfrantz DEDE, Manuel Mateo, Jason C. McDonald
+ */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_MODALITY_HPP
+#define GOLDILOCKS_MODALITY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "goldilocks/hdr_histogram.hpp"
+
+/// One mode (peak) of a distribution.
+struct DistributionMode {
+	/// Where the density peaks, in ticks.
+	double location = 0;
+
+	/// The lowest value belonging to this mode, in ticks.
+	double low = 0;
+
+	/// The highest value belonging to this mode, in ticks.
+	double high = 0;
+
+	/// The fraction of samples belonging to this mode, from 0 to 1.
+	double weight = 0;
+};
+
+/** The shape of a distribution: its moments, and its modes.
+ * Modes are found as the peaks of a kernel density estimate, taken over
+ * the logarithm of the samples, since timings tend to spread in
+ * proportion to their size. A peak only counts as its own mode if the
+ * density dips well below it on the way to the next one, and it holds
+ * at least 1% of the samples, and no fewer than 20 of them.*/
+struct Modality {
+	/// The sample skewness.
+	double skewness = 0;
+
+	/// The sample excess kurtosis (0 for a normal distribution).
+	double kurtosis = 0;
+
+	/** Sarle's bimodality coefficient, from 0 to 1. Values above 5/9
+	 * (that of a uniform distribution) suggest more than one mode.*/
+	double bimodality = 0;
+
+	/// The modes, in order of location.
+	std::vector<DistributionMode> modes;
+
+	/// \return true if more than one mode was found, else false
+	bool multimodal() const { return this->modes.size() > 1; }
+};
+
+/// The bimodality coefficient of a uniform distribution.
+const double BIMODALITY_THRESHOLD = 5.0 / 9.0;
+
+/**Analyze the shape of a series.
+ * \param the series
+ * \param the size of the series
+ * \param the smallest sample
+ * \param the largest sample
+ * \param the mean of the series
+ * \return the shape of the series
+ */
+Modality analyze_modality(const uint64_t*, size_t, uint64_t, uint64_t, double);
+
+/**Analyze the shape of a histogram, to its precision.
+ * \param the histogram
+ * \return the shape of the histogram
+ */
+Modality analyze_modality(const HdrHistogram&);
+
+#endif  // GOLDILOCKS_MODALITY_HPP
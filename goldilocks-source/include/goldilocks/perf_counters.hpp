@@ -0,0 +1,176 @@
+/** Performance Counters [Goldilocks]
+ * Version: 2.0
+ *
+ * Collects hardware and software event counts around measurements, using
+ * Linux's perf_event_open.
+ *
+ * Author(s): Wilfrantz DEDE, Manuel Mateo, Jason C. McDonald
+ */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_PERF_COUNTERS_HPP
+#define GOLDILOCKS_PERF_COUNTERS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "goldilocks/clock.hpp"
+
+// MACRO IF the platform offers perf_event_open.
+#if defined __linux__
+#define GOLDILOCKS_HAS_PERF 1
+#else
+#define GOLDILOCKS_HAS_PERF 0
+#endif
+
+/// The events that can be counted around a measurement.
+enum class Counter {
+	/// Instructions retired (hardware).
+	instructions,
+	/// CPU cycles (hardware).
+	cycles,
+	/// Last-level cache references (hardware).
+	cache_references,
+	/// Last-level cache misses (hardware).
+	cache_misses,
+	/// Mispredicted branches (hardware).
+	branch_misses,
+	/// Time on the CPU, in nanoseconds (software).
+	task_clock,
+	/// Page faults (software).
+	page_faults,
+	/// Context switches (software).
+	context_switches,
+	/// Heap allocations (counted by AllocTracker, not perf).
+	allocations,
+	/// Heap frees (counted by AllocTracker, not perf).
+	frees,
+	/// Bytes allocated on the heap (counted by AllocTracker, not perf).
+	allocated_bytes
+};
+
+/// How many kinds of Counter there are.
+const size_t COUNTER_COUNT = 11;
+
+/// One count of each event, indexed by Counter, or NaN if it wasn't counted.
+typedef std::array<double, COUNTER_COUNT> CounterValues;
+
+/**Get a printable name for a counter.
+ * \param the counter
+ * \return the name of the counter
+ */
+const char* counter_name(Counter);
+
+/**Get the bit that stands for a counter in a mask of counters.
+ * \param the counter
+ * \return the bit
+ */
+inline uint32_t counter_bit(Counter counter)
+{
+	return 1u << static_cast<uint32_t>(counter);
+}
+
+/** Counts events on the calling thread while enabled. Hardware events
+ * share one group, so they are counted over exactly the same instructions,
+ * and software events another. Where the PMU is unavailable, as in many
+ * virtual machines, only the software events are counted.*/
+class CounterGroup
+{
+protected:
+	/// The file descriptor of each counter, or -1 if it isn't open.
+	std::array<int, COUNTER_COUNT> fds;
+
+	/// The leaders of the hardware and software groups, or -1.
+	int leaders[2] = {-1, -1};
+
+	/// The counters in each group, in the order the group reads them.
+	std::array<Counter, COUNTER_COUNT> members[2];
+
+	/// How many counters are in each group.
+	size_t sizes[2] = {0, 0};
+
+	/// What counting an empty measurement costs, taken off every count.
+	CounterValues baseline;
+
+	/**Open a counter, and add it to its group.
+	 * \param the counter
+	 * \param the group: 0 for hardware, 1 for software
+	 * \param the perf event type
+	 * \param the perf event config
+	 */
+	void open_counter(Counter, size_t, uint32_t, uint64_t);
+
+	/**Read one group's counts, scaled for any time it wasn't counting.
+	 * \param the group: 0 for hardware, 1 for software
+	 * \param [out] the counts, by counter
+	 */
+	void read_group(size_t, CounterValues&) const;
+
+public:
+	CounterGroup();
+	CounterGroup(const CounterGroup&) = delete;
+	CounterGroup& operator=(const CounterGroup&) = delete;
+
+	/**Open every counter this host will let us have.
+	 * \return a mask of the counters opened (see counter_bit())
+	 */
+	uint32_t open();
+
+	/**Measure what counting an empty measurement costs, so it can be
+	 * taken back out, as calibrate() does for the clock.
+	 * \param the clock source that measurements use
+	 * \param the number of empty measurements to take
+	 */
+	void calibrate(ClockSource, uint32_t = 100);
+
+	/// Reset the counts, and start counting.
+	void start();
+
+	/// Stop counting.
+	void stop();
+
+	/**Read the counts since start(), less the baseline.
+	 * \param [out] the counts, by counter; those not open are 0, and
+	 * those whose group never got onto the PMU are NaN
+	 */
+	void read(CounterValues&) const;
+
+	~CounterGroup();
+};
+
+#endif  // GOLDILOCKS_PERF_COUNTERS_HPP
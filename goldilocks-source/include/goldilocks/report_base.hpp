@@ -57,7 +57,7 @@
 
 class ReportBase{
 	public:
-		ReportBase();
+		ReportBase() = default;
 		virtual void lap() = 0;
 		~ReportBase() = default;
 
@@ -0,0 +1,174 @@
+/** Run Budget [Goldilocks]
+ * Version: 2.0
+ *
+ * How many times, and for how long, a runner repeats a test.
+ *
+ * Author(s): Wilfrantz Dede, Jason C. McDonald
+ */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2016-2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_RUN_BUDGET_HPP
+#define GOLDILOCKS_RUN_BUDGET_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+/** How many times, and for how long, a runner repeats a test.
+ * A budget constructed from a plain number runs exactly that many
+ * iterations, so it can be passed anywhere an iteration count was.
+ *
+ * A runner stops once it has run `iterations` times AND for at least
+ * `min_time_ns`, or as soon as `max_time_ns` has passed, but never
+ * before it has taken `min_samples`.
+ */
+class RunBudget
+{
+public:
+	/// The number of times to run the test.
+	uint64_t iterations = 1;
+
+	/// Never stop before this many samples, even past max_time_ns.
+	uint64_t min_samples = 0;
+
+	/// Keep running for at least this long, in nanoseconds. 0 for no minimum.
+	uint64_t min_time_ns = 0;
+
+	/// Stop once this much time has passed, in nanoseconds. 0 for no limit.
+	uint64_t max_time_ns = 0;
+
+	/* Ctor for a fixed number of iterations.
+	 * \param iterations The number of times to run the test
+	 */
+	// cppcheck-suppress noExplicitConstructor
+	RunBudget(uint64_t iterations = 1) : iterations(iterations) {}
+
+	/* Create a budget that runs for a fixed amount of time.
+	 * \param time_ns How long to run for, in nanoseconds
+	 * \param min_samples The fewest samples to take, however long they take
+	 * \return the budget
+	 */
+	static RunBudget for_time(uint64_t time_ns, uint64_t min_samples = 1)
+	{
+		RunBudget budget(0);
+		budget.min_time_ns = time_ns;
+		budget.max_time_ns = time_ns;
+		budget.min_samples = min_samples;
+		return budget;
+	}
+
+	/* Check whether the runner needs to watch the clock at all.
+	 * \return true if either time limit is set, else false
+	 */
+	bool is_timed() const { return min_time_ns != 0 || max_time_ns != 0; }
+
+	/* Check whether the budget has been used up.
+	 * \param samples The number of samples taken so far
+	 * \param elapsed_ns How long the runner has been running, in nanoseconds
+	 * \return true if the runner should stop, else false
+	 */
+	bool exhausted(uint64_t samples, uint64_t elapsed_ns = 0) const
+	{
+		// Nothing stops us before the sample floor.
+		if (samples < min_samples) {
+			return false;
+		}
+		// The time limit trumps the iteration count.
+		if (max_time_ns != 0 && elapsed_ns >= max_time_ns) {
+			return true;
+		}
+		return samples >= iterations && elapsed_ns >= min_time_ns;
+	}
+
+	/* Estimate how many samples the budget will take, for reserving
+	 * storage. Time-limited budgets may take more or fewer.
+	 * \return the expected number of samples
+	 */
+	uint64_t expected_samples() const
+	{
+		return std::max(iterations, min_samples);
+	}
+};
+
+/** Tracks a runner's progress through a RunBudget.
+ * The clock is only read if the budget has a time limit.
+ */
+class BudgetTracker
+{
+protected:
+	const RunBudget& budget;
+	uint64_t samples = 0;
+	std::chrono::steady_clock::time_point start;
+
+public:
+	/* Ctor, starts tracking immediately.
+	 * \param budget The budget to track
+	 */
+	explicit BudgetTracker(const RunBudget& budget)
+	: budget(budget), start(std::chrono::steady_clock::now())
+	{
+	}
+
+	/* Count one more sample (or iteration) toward the budget.*/
+	void count() { ++this->samples; }
+
+	/* Get the number of samples counted so far.
+	 * \return the number of samples
+	 */
+	uint64_t get_samples() const { return this->samples; }
+
+	/* Get how long we have been tracking.
+	 * \return the elapsed time in nanoseconds
+	 */
+	uint64_t elapsed_ns() const
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				   std::chrono::steady_clock::now() - this->start)
+			.count();
+	}
+
+	/* Check whether the budget has been used up.
+	 * \return true if the runner should stop, else false
+	 */
+	bool done() const
+	{
+		return this->budget.exhausted(
+			this->samples, this->budget.is_timed() ? this->elapsed_ns() : 0);
+	}
+};
+
+#endif  // GOLDILOCKS_RUN_BUDGET_HPP
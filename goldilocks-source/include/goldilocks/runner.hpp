@@ -44,14 +44,31 @@
 #ifndef GOLDILOCKS_RUNNER_HPP
 #define GOLDILOCKS_RUNNER_HPP
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <deque>
+#include <functional>
+#include <random>
+#include <utility>
 #include <variant>
+#include <vector>
 
+#include "goldilocks/affinity.hpp"
+#include "goldilocks/alloc_tracker.hpp"
+#include "goldilocks/benchmark_options.hpp"
 #include "goldilocks/benchmark_results.hpp"
 #include "goldilocks/clock.hpp"
+#include "goldilocks/isolation.hpp"
+#include "goldilocks/perf_counters.hpp"
+#include "goldilocks/run_budget.hpp"
+#include "goldilocks/sequential_test.hpp"
+#include "goldilocks/statistics.hpp"
+#include "goldilocks/streaming_stats.hpp"
 #include "goldilocks/suite.hpp"
 #include "goldilocks/test.hpp"
 #include "goldilocks/types.hpp"
+#include "goldilocks/warmup.hpp"
 
 // Empty runner to allow for specialization
 template<typename T> class Runner;
@@ -62,16 +79,16 @@ template<> class Runner<Test>
 protected:
 	Test* test;
 	Test* comparative;
-	uint16_t iterations;
+	RunBudget budget;
 
 public:
 	/* Ctor, stores test information
 	 * \param test The test to run
 	 * \param comparative The test to compare to
-	 * \param iterations The number of times to repeat the test
+	 * \param budget How many times (or how long) to repeat the test
 	 */
-	Runner(Test* test, Test* comparative, uint16_t iterations = 1)
-	: test(test), comparative(comparative), iterations(iterations)
+	Runner(Test* test, Test* comparative, RunBudget budget = RunBudget())
+	: test(test), comparative(comparative), budget(budget)
 	{
 	}
 
@@ -87,7 +104,8 @@ public:
 			return false;
 		}
 
-		for (uint16_t i = 0; i < this->iterations; ++i) {
+		for (BudgetTracker tracker(this->budget); !tracker.done();
+			 tracker.count()) {
 			// run janitor() from test. If fails, call postmortem()
 			if (!this->test->janitor()) {
 				this->test->postmortem();
@@ -112,30 +130,199 @@ class BenchmarkRunner final : public Runner<Test>
 {
 protected:
 	BenchmarkResult results;
+	BenchmarkOptions options;
+
+	/// The clock source used for this run.
+	ClockSource source = ClockSource::steady;
+	/// The clock overhead taken out of each measurement.
+	ClockOverhead overhead;
+	/// How many runs of the test go into each measurement.
+	uint64_t batch_test = 1;
+	/// How many runs of the comparative go into each measurement.
+	uint64_t batch_comparative = 1;
+	/// The generator for random interleaving.
+	std::mt19937_64 order_rng;
+
+	/// The most pairs of samples we'll reserve storage for up front.
+	static constexpr uint64_t MAX_RESERVED_PAIRS = 1ULL << 24;
+
+	/// Where a child process writes its samples, or nullptr to keep them.
+	PipeWriter* sink = nullptr;
+
+	/// The time spent resetting one side, over the measurements it took.
+	struct ResetCost {
+		/// The total time spent resetting, in ns.
+		double total_ns = 0;
+		/// How many resets there were.
+		uint64_t count = 0;
+
+		/* Count one reset. Only the mean is reported, so this is kept
+		 * cheap enough not to show up in the next reset.
+		 * \param ns How long the reset took, in ns
+		 */
+		void add(double ns)
+		{
+			this->total_ns += ns;
+			++this->count;
+		}
+
+		/* \return the mean time of a reset, in ns, or 0 if there were none
+		 */
+		double mean() const
+		{
+			return (this->count > 0) ? this->total_ns / this->count : 0;
+		}
+	};
+	/// How long resetting took before each test measurement.
+	ResetCost reset_a;
+	/// How long resetting took before each comparative measurement.
+	ResetCost reset_b;
+	/// What timing a reset with steady_now() costs by itself, in ns.
+	double reset_timing_ns = 0;
+	/// A pair measured in snapshots.
+	struct SnapshotPair {
+		uint64_t measurement_a;
+		uint64_t measurement_b;
+		/// Whether the thread changed CPU while measuring either side.
+		bool migrated;
+		/// Whether the thread was preempted while measuring either side.
+		bool preempted;
+	};
+	/// Pairs measured in snapshots that haven't been handed out yet.
+	std::deque<SnapshotPair> snapshot_pairs;
+	/// How many rounds of snapshots have been taken.
+	uint64_t snapshot_rounds = 0;
+
+	/// The placement of the thread, valid only while a run is going.
+	ThreadPlacement* placement = nullptr;
+	/// Where, and how, the thread has run so far.
+	Placement placed;
+	/// Whether the thread changed CPU during the last measurement.
+	bool migrated = false;
+	/// Whether the thread was preempted during the last measurement.
+	bool preempted = false;
+
+	/// The event counters, valid only while a run is counting.
+	CounterGroup* counters = nullptr;
+	/// The counters that are open, as a mask of counter_bit()s.
+	uint32_t counter_mask = 0;
+	/// Whether allocations are counted, valid only while a run is counting.
+	bool tracking = false;
+	/// The events counted per run in the last measurement of each side.
+	CounterValues counts[2];
+	/** The most times to measure a pair again because the thread moved,
+	 * or was preempted. */
+	static constexpr uint32_t MAX_PERTURBED_RETRIES = 100;
+
+	/// Tags a pair of measurements written by a child process.
+	static constexpr char RECORD_PAIR = 'P';
+	/// Tags a single side's measurement written by a child process.
+	static constexpr char RECORD_SAMPLE = 'S';
+	/// Tags the event counts of the pair or sample that follows.
+	static constexpr char RECORD_COUNTS = 'C';
+	/// Tags a measurement during which the thread changed CPU.
+	static constexpr char RECORD_MIGRATED = 'M';
+	/// Tags a measurement during which the thread was preempted.
+	static constexpr char RECORD_PREEMPTED = 'I';
+	/// Tags how a child process sampled, written once it is done.
+	static constexpr char RECORD_SUMMARY = 'R';
+
+	/** What the parent needs to finalize the samples from a child: how
+	 * they were measured. It is written through a pipe, so it is kept
+	 * trivially copyable. */
+	struct RunSummary {
+		ClockCalibration calibration;
+		uint64_t overhead_estimate = 0;
+		uint64_t overhead_noise_floor = 0;
+		uint64_t batch_test = 1;
+		uint64_t batch_comparative = 1;
+		WarmupResult warmup_test;
+		WarmupResult warmup_comparative;
+		PowerAdvice advice;
+		EarlyStop early_stop = EarlyStop::none;
+		uint64_t early_stop_looks = 0;
+		Reset reset = Reset::janitor;
+		double reset_ns_test = 0;
+		double reset_ns_comparative = 0;
+		Placement placement;
+		uint32_t counters = 0;
+	};
 
 public:
 	/* Ctor for the BenchmarkRunner
 	 * \param test The test to run
 	 * \param comparative The test to compare it to
-	 * \param iterations The number of times to run the test
+	 * \param budget How many times (or how long) to run the test
+	 * \param options The benchmark configuration
 	 */
-	BenchmarkRunner(Test* test, Test* comparative, uint16_t iterations = 1)
-	: Runner(test, comparative, iterations), results()
+	BenchmarkRunner(Test* test,
+					Test* comparative,
+					RunBudget budget = RunBudget(),
+					const BenchmarkOptions& options = BenchmarkOptions())
+	: Runner(test, comparative, budget),
+	  results(),
+	  options(options),
+	  order_rng(options.seed)
 	{
 	}
 
-	/* Runs the test
+	/* Runs the test, here or in child processes, as the options ask.
 	 * \return bool True if the test is succesful, false if not
 	 */
 	bool run() override
 	{
+		switch (options.isolation) {
+			case Isolation::benchmark:
+				return this->run_isolated();
+			case Isolation::side:
+				return this->run_sides_isolated();
+			case Isolation::none:
+				[[fallthrough]];
+			default:
+				if (!this->run_here()) {
+					this->results.set_status(Status::Fail,
+											 "the test or comparative failed");
+					return false;
+				}
+				return true;
+		}
+	}
+
+	/* Get the benchmark result
+	 * \return the result of the last run
+	 */
+	const BenchmarkResult& get_result() const { return this->results; }
+
+	~BenchmarkRunner() = default;
+
+protected:
+	/* Run the test in this process. In a child process, the samples are
+	 * written to the sink for the parent to finalize, not kept here.
+	 * \return bool True if the test is succesful, false if not
+	 */
+	bool run_here()
+	{
+		this->reset_a = ResetCost();
+		this->reset_b = ResetCost();
+		this->snapshot_pairs.clear();
+		this->snapshot_rounds = 0;
+
+		// Place the thread as asked, until this run returns.
+		ThreadPlacement placement;
+		this->place(placement, this->test);
+		CounterGroup counters;
+		this->counters = nullptr;
+		this->counter_mask = 0;
+		this->tracking = false;
+
 		// Initialize test
 		if (!this->test->pre()) {
 			this->test->prefail();
 			return false;
 		}
-		// Validate that test runs.
-		if (!this->test->run_optimized()) {
+		// Validate that test runs, timing it as a cold start.
+		WarmupResult warmup_test, warmup_comparative;
+		if (!this->validate(this->test, warmup_test.first_run_ns)) {
 			this->test->postmortem();
 			return false;
 		}
@@ -146,30 +333,128 @@ public:
 			return false;
 		}
 
-		if (!this->comparative->run_optimized()) {
+		if (!this->validate(this->comparative,
+							warmup_comparative.first_run_ns)) {
+			this->comparative->postmortem();
+			this->test->post();
+			return false;
+		}
+
+		// Start from an empty result, in case we're running again.
+		this->reset_results();
+
+		// Pick the clock source once, so every sample uses the same one.
+		this->source = resolve_clock_source(options.clock_source);
+		this->results.set_calibration(calibrate_clock(this->source));
+
+		// Measure the cost of measuring, so it can be taken back out.
+		this->overhead = calibrate(this->source, options.overhead_samples);
+		if (!options.subtract_overhead) {
+			this->overhead.estimate = 0;
+		}
+		this->time_resets();
+		this->count_with(counters);
+
+		// Find how many runs of each test go into a single measurement.
+		const double target_ticks =
+			this->results.get_calibration().to_ticks(options.batch_target_ns);
+		this->batch_test = this->size_batch(this->test, target_ticks);
+		this->batch_comparative =
+			this->size_batch(this->comparative, target_ticks);
+		if (this->batch_test == 0) {
+			this->test->postmortem();
+			this->comparative->post();
+			return false;
+		}
+		if (this->batch_comparative == 0) {
 			this->comparative->postmortem();
 			this->test->post();
 			return false;
 		}
+		this->results.set_batch_sizes(this->batch_test,
+									  this->batch_comparative);
+
+		// Run both tests until their measurements settle.
+		if (options.warmup &&
+			!this->warm_up(warmup_test, warmup_comparative)) {
+			return false;
+		}
+		this->results.set_warmup(warmup_test, warmup_comparative);
+
+		/* Size the run from a pilot, if asked. Work on a copy, so that
+		 * running again pilots afresh.*/
+		RunBudget budget = this->budget;
+		if (options.pilot_samples > 0 && !this->pilot(budget)) {
+			return false;
+		}
+
+		// Store samples up front, so nothing reallocates between pairs.
+		if (this->sink == nullptr) {
+			this->results.reserve(
+				std::min(budget.expected_samples(), MAX_RESERVED_PAIRS));
+		}
+
+		// Check the comparison as it goes, in case it settles early.
+		SequentialTest sequential(options.early_stop,
+								  options.alpha,
+								  options.early_stop_precision,
+								  options.early_stop_interval);
+		// Stop on whatever the verdict will be judged on.
+		const bool by_instructions =
+			options.metric == Metric::instructions &&
+			(this->counter_mask & counter_bit(Counter::instructions)) != 0;
+
+		// Only report what resetting cost while sampling.
+		this->reset_a = ResetCost();
+		this->reset_b = ResetCost();
 
 		// Actual benchmarking
-		for (uint16_t i = 0; i < this->iterations; ++i) {
-			if (!this->test->janitor()) {
-				this->test->postmortem();
-				this->comparative->post();
+		this->order_rng.seed(options.seed);
+		for (BudgetTracker tracker(budget); !tracker.done(); tracker.count()) {
+			uint64_t measurement_a, measurement_b;
+			if (!this->measure_pair(
+					tracker.get_samples(), measurement_a, measurement_b)) {
 				return false;
 			}
-
-			if (!this->comparative->janitor()) {
-				this->comparative->postmortem();
-				this->test->post();
-				return false;
+			if (this->sink != nullptr) {
+				// The counts go first, so the parent has them with the pair.
+				if (this->counter_mask != 0) {
+					this->sink->write(RECORD_COUNTS, this->counts);
+				}
+				const uint64_t pair[2] = {measurement_a, measurement_b};
+				this->sink->write(RECORD_PAIR, pair);
+			} else {
+				this->results.add_measurement(measurement_a, measurement_b);
+				if (this->counter_mask != 0) {
+					this->results.add_counts(this->counts[0], this->counts[1]);
+				}
 			}
+			// Pairs whose instructions weren't counted can't settle on them.
+			const bool settled =
+				by_instructions
+					? (this->instructions_counted() &&
+					   sequential.add(this->instructions(0),
+									  this->instructions(1)))
+					: sequential.add(measurement_a, measurement_b);
+			if (settled) {
+				break;
+			}
+		}
+		this->results.set_early_stop(sequential.stopped(),
+									 sequential.get_looks());
 
-			// clock() calls test->run_optimized() and
-			// comparative->run_optimized()
-			this->results.add_measurement(clock(this->test),
-										  clock(this->comparative));
+		if (this->sink != nullptr) {
+			// The parent finalizes; it only needs to know how we sampled.
+			this->sink->write(RECORD_SUMMARY, this->summarize());
+		} else {
+			this->results.set_reset_cost(
+				options.reset, this->reset_a.mean(), this->reset_b.mean());
+			this->results.set_placement(this->placed);
+			this->results.set_counters(
+				options.collect_counters || options.track_allocations,
+				this->counter_mask);
+			this->results.set_overhead(this->overhead);
+			this->results.finalize();
 		}
 
 		this->test->post();
@@ -177,7 +462,975 @@ public:
 		return true;
 	}
 
-	~BenchmarkRunner() = default;
+	/* Start from an empty result, configured by the options.
+	 */
+	void reset_results()
+	{
+		this->results = BenchmarkResult();
+		this->results.set_storage(options.storage,
+								  options.histogram_highest,
+								  options.histogram_significant_figures);
+		this->results.set_outlier_policy(options.outliers);
+		this->results.set_verdict_method(
+			options.verdict_method, options.alpha, options.max_rsd);
+		this->results.set_bootstrap(options.bootstrap_resamples,
+									options.bootstrap_threads,
+									options.seed);
+		this->results.set_metric(options.metric,
+								 options.instruction_tolerance);
+	}
+
+	/* Describe how this run sampled, for a parent process.
+	 * \return the summary of the run
+	 */
+	RunSummary summarize() const
+	{
+		RunSummary summary;
+		summary.calibration = this->results.get_calibration();
+		summary.overhead_estimate = this->overhead.estimate;
+		summary.overhead_noise_floor = this->overhead.noise_floor;
+		summary.batch_test = this->batch_test;
+		summary.batch_comparative = this->batch_comparative;
+		summary.warmup_test = this->results.get_test_warmup();
+		summary.warmup_comparative = this->results.get_comparative_warmup();
+		summary.advice = this->results.get_power_advice();
+		summary.early_stop = this->results.get_early_stop();
+		summary.early_stop_looks = this->results.get_early_stop_looks();
+		summary.reset = options.reset;
+		summary.reset_ns_test = this->reset_a.mean();
+		summary.reset_ns_comparative = this->reset_b.mean();
+		summary.placement = this->placed;
+		summary.counters = this->counter_mask;
+		return summary;
+	}
+
+	/* Take on how a child process sampled, before finalizing its samples.
+	 * \param summary The summary the child wrote
+	 */
+	void apply(const RunSummary& summary)
+	{
+		this->results.set_calibration(summary.calibration);
+		this->overhead = ClockOverhead();
+		this->overhead.estimate = summary.overhead_estimate;
+		this->overhead.noise_floor = summary.overhead_noise_floor;
+		this->batch_test = summary.batch_test;
+		this->batch_comparative = summary.batch_comparative;
+		this->results.set_batch_sizes(this->batch_test,
+									  this->batch_comparative);
+		this->results.set_warmup(summary.warmup_test,
+								 summary.warmup_comparative);
+		this->results.set_power_advice(summary.advice);
+		this->results.set_early_stop(summary.early_stop,
+									 summary.early_stop_looks);
+		this->results.set_reset_cost(summary.reset,
+									 summary.reset_ns_test,
+									 summary.reset_ns_comparative);
+		this->results.set_placement(summary.placement);
+		this->results.set_counters(
+			options.collect_counters || options.track_allocations,
+			summary.counters);
+	}
+
+	/* Start a child process that writes its samples back to us. The
+	 * child places its own thread, as the options ask.
+	 * \param child The child process to start
+	 * \param body What the child runs, returning true if it succeeded
+	 * \return true if the child started, else false
+	 */
+	bool spawn(ChildProcess& child, const std::function<bool()>& body)
+	{
+		return child.spawn([this, &body](int fd) {
+			PipeWriter writer(fd);
+			this->sink = &writer;
+			const bool succeeded = body();
+			return (writer.flush() && succeeded) ? 0 : 1;
+		});
+	}
+
+	/* Finalize the samples from isolated children, unless one failed.
+	 * \param exits How each child ended
+	 * \param summary How the children sampled, or nullptr if they never
+	 * said
+	 * \return true if the benchmark finished, else false
+	 */
+	bool finish_isolated(const std::vector<ChildExit>& exits,
+						 const RunSummary* summary)
+	{
+		for (const ChildExit& exit : exits) {
+			if (!exit.succeeded) {
+				this->results.set_status(Status::Fail, exit.reason);
+				return false;
+			}
+		}
+		if (summary == nullptr) {
+			this->results.set_status(Status::Fail,
+									 "the child process sent no results");
+			return false;
+		}
+		this->apply(*summary);
+		this->results.set_overhead(this->overhead);
+		this->results.finalize();
+		return true;
+	}
+
+	/* Run the whole benchmark in a child process, which streams its
+	 * samples back. A crash or hang fails this benchmark alone.
+	 * \return bool True if the test is succesful, false if not
+	 */
+	bool run_isolated()
+	{
+		this->reset_results();
+		ChildProcess child;
+		if (!this->spawn(child, [this]() { return this->run_here(); })) {
+			this->results.set_status(Status::Fail,
+									 "could not start a child process");
+			return false;
+		}
+
+		RunSummary summary;
+		bool summarized = false;
+		bool counted = false;
+		std::vector<ChildProcess*> children = {&child};
+		ChildProcess::read_all(
+			children,
+			options.isolation_timeout_ns,
+			[&](size_t, char tag, const std::string& payload) {
+				uint64_t pair[2];
+				if (tag == RECORD_COUNTS &&
+					read_record(payload, this->counts)) {
+					counted = true;
+				} else if (tag == RECORD_PAIR && read_record(payload, pair)) {
+					this->results.add_measurement(pair[0], pair[1]);
+					if (counted) {
+						this->results.add_counts(this->counts[0],
+												 this->counts[1]);
+					}
+				} else if (tag == RECORD_SUMMARY) {
+					summarized = read_record(payload, summary);
+				}
+			});
+		return this->finish_isolated({child.wait()},
+									 summarized ? &summary : nullptr);
+	}
+
+	/* Run each side in its own child process, at the same time, and pair
+	 * their samples up by index. Neither side can disturb the other's
+	 * heap or cache, but pairs no longer share a moment on one core.
+	 * Pilots and early stopping need both sides, so they are skipped.
+	 * \return bool True if the test is succesful, false if not
+	 */
+	bool run_sides_isolated()
+	{
+		this->reset_results();
+		ChildProcess child_a, child_b;
+		auto side_a = [this]() { return this->run_side(this->test); };
+		auto side_b = [this]() { return this->run_side(this->comparative); };
+		if (!this->spawn(child_a, side_a) || !this->spawn(child_b, side_b)) {
+			this->results.set_status(Status::Fail,
+									 "could not start a child process");
+			return false;
+		}
+
+		// Samples wait here until the other side has one to pair with.
+		std::deque<std::pair<uint64_t, CounterValues>> queued[2];
+		CounterValues side_counts[2] = {};
+		bool counted = false;
+		RunSummary summaries[2];
+		bool summarized[2] = {false, false};
+		std::vector<ChildProcess*> children = {&child_a, &child_b};
+		ChildProcess::read_all(
+			children,
+			options.isolation_timeout_ns,
+			[&](size_t side, char tag, const std::string& payload) {
+				uint64_t measurement;
+				if (tag == RECORD_COUNTS &&
+					read_record(payload, side_counts[side])) {
+					counted = true;
+				} else if (tag == RECORD_SAMPLE &&
+						   read_record(payload, measurement)) {
+					queued[side].emplace_back(measurement, side_counts[side]);
+					if (!queued[0].empty() && !queued[1].empty()) {
+						this->results.add_measurement(queued[0].front().first,
+													  queued[1].front().first);
+						if (counted) {
+							this->results.add_counts(queued[0].front().second,
+													 queued[1].front().second);
+						}
+						queued[0].pop_front();
+						queued[1].pop_front();
+					}
+				} else if (tag == RECORD_SUMMARY) {
+					summarized[side] = read_record(payload, summaries[side]);
+				}
+			});
+
+		std::vector<ChildExit> exits = {child_a.wait(), child_b.wait()};
+		exits[0].reason = "the test " + exits[0].reason;
+		exits[1].reason = "the comparative " + exits[1].reason;
+
+		// Each side wrote its own summary as the test; merge the two.
+		RunSummary summary = summaries[0];
+		summary.batch_comparative = summaries[1].batch_test;
+		summary.warmup_comparative = summaries[1].warmup_test;
+		summary.reset_ns_comparative = summaries[1].reset_ns_test;
+		summary.counters &= summaries[1].counters;
+		const Placement& placed_b = summaries[1].placement;
+		summary.placement.migrations += placed_b.migrations;
+		summary.placement.preemptions += placed_b.preemptions;
+		summary.placement.discarded += placed_b.discarded;
+		if (placed_b.pinning == Granted::refused) {
+			summary.placement.pinning = Granted::refused;
+		}
+		summary.overhead_noise_floor =
+			std::max(summaries[0].overhead_noise_floor,
+					 summaries[1].overhead_noise_floor);
+		return this->finish_isolated(
+			exits, (summarized[0] && summarized[1]) ? &summary : nullptr);
+	}
+
+	/* Benchmark one side alone, writing each measurement to the sink.
+	 * This is the per-side counterpart of run_here().
+	 * \param test The test to run
+	 * \return true if the test ran, false if it failed
+	 */
+	bool run_side(Test* test)
+	{
+		ThreadPlacement placement;
+		this->place(placement, test);
+		CounterGroup counters;
+		this->counters = nullptr;
+		this->counter_mask = 0;
+		this->tracking = false;
+
+		if (!test->pre()) {
+			test->prefail();
+			return false;
+		}
+		RunSummary summary;
+		const uint64_t cold_start = steady_now();
+		if (!test->run_optimized()) {
+			test->postmortem();
+			return false;
+		}
+		summary.warmup_test.first_run_ns = steady_now() - cold_start;
+
+		this->source = resolve_clock_source(options.clock_source);
+		summary.calibration = calibrate_clock(this->source);
+		this->overhead = calibrate(this->source, options.overhead_samples);
+		if (!options.subtract_overhead) {
+			this->overhead.estimate = 0;
+		}
+		this->time_resets();
+		this->count_with(counters);
+
+		const uint64_t batch = this->find_batch_size(
+			test, summary.calibration.to_ticks(options.batch_target_ns));
+		if (batch == 0) {
+			test->postmortem();
+			return false;
+		}
+
+		const size_t side = (test == this->comparative) ? 1 : 0;
+		ResetCost reset;
+		auto measure_one = [&](uint64_t, uint64_t* measurement) {
+			return this->unperturbed([&]() {
+				const uint64_t start = steady_now();
+				if (!test->janitor()) {
+					test->postmortem();
+					return false;
+				}
+				this->add_reset(reset, start, steady_now());
+				measurement[0] = this->measure(test, batch);
+				return true;
+			});
+		};
+		if (options.warmup &&
+			!this->settle(measure_one, &batch, &summary.warmup_test, 1)) {
+			return false;
+		}
+		// Only report what resetting cost while sampling.
+		reset = ResetCost();
+
+		for (BudgetTracker tracker(this->budget); !tracker.done();
+			 tracker.count()) {
+			uint64_t measurement;
+			if (!measure_one(tracker.get_samples(), &measurement)) {
+				return false;
+			}
+			if (this->counter_mask != 0) {
+				this->sink->write(RECORD_COUNTS, this->counts[side]);
+			}
+			this->sink->write(RECORD_SAMPLE, measurement);
+		}
+
+		summary.overhead_estimate = this->overhead.estimate;
+		summary.overhead_noise_floor = this->overhead.noise_floor;
+		summary.batch_test = batch;
+		summary.reset_ns_test = reset.mean();
+		summary.placement = this->placed;
+		summary.counters = this->counter_mask;
+		this->sink->write(RECORD_SUMMARY, summary);
+		test->post();
+		return true;
+	}
+
+	/* Clock one measurement of a test, with the clock overhead removed.
+	 * The thread is pinned for the test first, if the options ask. Any
+	 * change of CPU during the measurement is noted in migrated, and any
+	 * preemption in preempted. Any events counted are left, per run, in
+	 * counts.
+	 * \param test The test to measure
+	 * \param batch The number of runs in the measurement
+	 * \return the time of one run, in ticks
+	 */
+	uint64_t measure(Test* test, uint64_t batch)
+	{
+		this->pin_for(test);
+		const int cpu = current_cpu();
+		const uint64_t preemptions = preemption_count();
+		// Track outside the counters, so they don't count the tracker.
+		AllocCounts allocated;
+		if (this->tracking) {
+			allocated = AllocTracker::start();
+		}
+		if (this->counters != nullptr) {
+			this->counters->start();
+		}
+		// clock() calls test->run_optimized()
+		const uint64_t ticks = clock(test, this->source, batch);
+		if (this->counters != nullptr) {
+			this->counters->stop();
+		}
+		if (this->counter_mask != 0) {
+			CounterValues& counts =
+				this->counts[(test == this->comparative) ? 1 : 0];
+			counts.fill(0);
+			if (this->counters != nullptr) {
+				this->counters->read(counts);
+			}
+			if (this->tracking) {
+				allocated = AllocTracker::stop(allocated);
+				counts[static_cast<size_t>(Counter::allocations)] =
+					allocated.allocations;
+				counts[static_cast<size_t>(Counter::frees)] = allocated.frees;
+				counts[static_cast<size_t>(Counter::allocated_bytes)] =
+					allocated.bytes;
+			}
+			for (double& count : counts) {
+				count /= batch;
+			}
+		}
+		if (current_cpu() != cpu) {
+			this->migrated = true;
+		}
+		if (preemption_count() != preemptions) {
+			this->preempted = true;
+		}
+		return per_run(this->overhead.subtract(ticks), batch);
+	}
+
+	/* Get the instructions counted per run in the last measurement of a
+	 * side, to the nearest whole instruction.
+	 * \param side 0 for the test, 1 for the comparative
+	 * \return the instructions per run
+	 */
+	uint64_t instructions(size_t side) const
+	{
+		const double count =
+			this->counts[side][static_cast<size_t>(Counter::instructions)];
+		return (count > 0) ? static_cast<uint64_t>(llround(count)) : 0;
+	}
+
+	/* Check whether both sides' instructions were counted in the last
+	 * measurement. They aren't when the PMU was busy with something else.
+	 * \return true if both were counted, else false
+	 */
+	bool instructions_counted() const
+	{
+		const size_t c = static_cast<size_t>(Counter::instructions);
+		return !std::isnan(this->counts[0][c]) &&
+			   !std::isnan(this->counts[1][c]);
+	}
+
+	/* Count events, and allocations, around each measurement from now
+	 * on, if the options ask and this host allows it.
+	 * \param counters The counters, which must outlast the run
+	 */
+	void count_with(CounterGroup& counters)
+	{
+		// Snapshots measure in other processes, which we can't count.
+		if (options.reset == Reset::snapshot) {
+			return;
+		}
+		if (options.collect_counters ||
+			options.metric == Metric::instructions) {
+			this->counter_mask = counters.open();
+			if (this->counter_mask != 0) {
+				counters.calibrate(this->source);
+				this->counters = &counters;
+			}
+		}
+		// Without the library's allocator hooks, there's nothing to count.
+		if (options.track_allocations && AllocTracker::enabled()) {
+			this->tracking = true;
+			this->counter_mask |= counter_bit(Counter::allocations) |
+								  counter_bit(Counter::frees) |
+								  counter_bit(Counter::allocated_bytes);
+		}
+	}
+
+	/* Place this thread as the options ask, for as long as the placement
+	 * lasts, and start keeping track of where it runs.
+	 * \param placement The placement, which undoes itself when destroyed
+	 * \param first The test that will be measured first
+	 */
+	void place(ThreadPlacement& placement, Test* first)
+	{
+		this->placement = &placement;
+		this->placed = Placement();
+		this->placed.cpu_test = this->cpu_for(this->test);
+		this->placed.cpu_comparative = this->cpu_for(this->comparative);
+
+		// Pin first, so memory is locked, and faulted in, where we'll run.
+		this->pin_for(first);
+		if (options.realtime) {
+			this->placed.realtime =
+				placement.make_realtime(options.realtime_priority)
+					? Granted::granted
+					: Granted::refused;
+		}
+		if (options.lock_memory) {
+			this->placed.memory_lock = placement.lock_memory()
+										   ? Granted::granted
+										   : Granted::refused;
+		}
+	}
+
+	/* Find the CPU a test is measured on.
+	 * \param test The test or the comparative
+	 * \return the CPU, or -1 if it isn't pinned
+	 */
+	int cpu_for(const Test* test) const
+	{
+		if (test != this->comparative) {
+			return options.cpu_test;
+		}
+		if (options.cpu_comparative >= 0) {
+			return options.cpu_comparative;
+		}
+		// Isolated sides run at once, so they mustn't share a CPU.
+		if (options.isolation == Isolation::side && options.cpu_test >= 0) {
+			return options.cpu_test + 1;
+		}
+		return options.cpu_test;
+	}
+
+	/* Pin the thread to a test's CPU, if it has one. This costs nothing
+	 * if the thread is already there.
+	 * \param test The test about to be measured
+	 */
+	void pin_for(const Test* test)
+	{
+		const int cpu = this->cpu_for(test);
+		if (cpu < 0 || this->placement == nullptr) {
+			return;
+		}
+		if (!this->placement->pin(cpu)) {
+			this->placed.pinning = Granted::refused;
+		} else if (this->placed.pinning == Granted::not_asked) {
+			this->placed.pinning = Granted::granted;
+		}
+	}
+
+	/* Take a measurement, and take it again if the thread changed CPU
+	 * or was preempted during it, as long as the options ask for that.
+	 * \param measure Takes the measurement, returning false if it failed
+	 * \return true if measured, false if the measurement failed
+	 */
+	template<typename Measure> bool unperturbed(Measure measure)
+	{
+		for (uint32_t attempt = 0;; ++attempt) {
+			this->migrated = false;
+			this->preempted = false;
+			if (!measure()) {
+				return false;
+			}
+			// A migration is a preemption too; count it once, as that.
+			bool discard = false;
+			if (this->migrated) {
+				++this->placed.migrations;
+				discard = options.discard_migrations;
+			} else if (this->preempted) {
+				++this->placed.preemptions;
+				discard = options.discard_preemptions;
+			}
+			if (!discard || attempt >= MAX_PERTURBED_RETRIES) {
+				return true;
+			}
+			++this->placed.discarded;
+		}
+	}
+
+	/* Measure the test and the comparative once each, after running both
+	 * janitors, or from snapshots. If a janitor or snapshot fails, both
+	 * tests are cleaned up. Pairs in which the thread changed CPU, or was
+	 * preempted, are measured again, if the options ask.
+	 * \param pair The index of the pair of measurements
+	 * \param measurement_a [out] The measurement of the test
+	 * \param measurement_b [out] The measurement of the comparative
+	 * \return true if the pair was measured, false if a janitor failed
+	 */
+	bool measure_pair(uint64_t pair,
+					  uint64_t& measurement_a,
+					  uint64_t& measurement_b)
+	{
+		return this->unperturbed([&]() {
+			if (options.reset == Reset::snapshot) {
+				return this->measure_snapshot(measurement_a, measurement_b);
+			}
+			return this->clean_and_measure(
+				pair, measurement_a, measurement_b);
+		});
+	}
+
+	/* Measure what timing a reset costs by itself, so that it can be
+	 * taken back out of each reset.
+	 */
+	void time_resets()
+	{
+		this->reset_timing_ns =
+			(options.overhead_samples > 0 && options.subtract_overhead)
+				? calibrate(ClockSource::steady, options.overhead_samples)
+					  .estimate
+				: 0;
+	}
+
+	/* Count one reset, timed with steady_now(), less the cost of timing.
+	 * \param cost The reset cost to add to
+	 * \param start The time before the reset, in ns
+	 * \param stop The time after the reset, in ns
+	 */
+	void add_reset(ResetCost& cost, uint64_t start, uint64_t stop) const
+	{
+		const double elapsed = static_cast<double>(stop - start);
+		cost.add(std::max(elapsed - this->reset_timing_ns, 0.0));
+	}
+
+	/* Measure the test and the comparative once each, after running both
+	 * janitors. If a janitor fails, both tests are cleaned up.
+	 * \param pair The index of the pair of measurements
+	 * \param measurement_a [out] The measurement of the test
+	 * \param measurement_b [out] The measurement of the comparative
+	 * \return true if the pair was measured, false if a janitor failed
+	 */
+	bool clean_and_measure(uint64_t pair,
+						   uint64_t& measurement_a,
+						   uint64_t& measurement_b)
+	{
+		const uint64_t start = steady_now();
+		if (!this->test->janitor()) {
+			this->test->postmortem();
+			this->comparative->post();
+			return false;
+		}
+		const uint64_t cleaned = steady_now();
+		if (!this->comparative->janitor()) {
+			this->comparative->postmortem();
+			this->test->post();
+			return false;
+		}
+		const uint64_t done = steady_now();
+
+		// Record only once both are timed, so neither times the other's.
+		this->add_reset(this->reset_a, start, cleaned);
+		this->add_reset(this->reset_b, cleaned, done);
+
+		/* Vary which side goes first, so neither one is systematically
+		 * measured with the other's warm caches and branch history.*/
+		if (test_goes_first(pair)) {
+			measurement_a = measure(this->test, this->batch_test);
+			measurement_b = measure(this->comparative, this->batch_comparative);
+		} else {
+			measurement_b = measure(this->comparative, this->batch_comparative);
+			measurement_a = measure(this->test, this->batch_test);
+		}
+		return true;
+	}
+
+	/* Take the next pair of measurements from snapshots of the fixtures,
+	 * taking more snapshots once those are used up.
+	 * \param measurement_a [out] The measurement of the test
+	 * \param measurement_b [out] The measurement of the comparative
+	 * \return true if the pair was measured, false if a snapshot failed
+	 */
+	bool measure_snapshot(uint64_t& measurement_a, uint64_t& measurement_b)
+	{
+		if (this->snapshot_pairs.empty() && !this->take_snapshots()) {
+			return false;
+		}
+		const SnapshotPair& front = this->snapshot_pairs.front();
+		measurement_a = front.measurement_a;
+		measurement_b = front.measurement_b;
+		this->migrated = front.migrated;
+		this->preempted = front.preempted;
+		this->snapshot_pairs.pop_front();
+		return true;
+	}
+
+	/* Take a round of measurements in a snapshot of each side. The sides
+	 * take turns going first, as pairs do.
+	 * \return true if both were measured, false if a snapshot failed
+	 */
+	bool take_snapshots()
+	{
+		const uint64_t count =
+			std::max<uint64_t>(options.snapshot_measurements, 1);
+		std::vector<uint64_t> measurements[2];
+		std::vector<bool> migrations(count, false);
+		std::vector<bool> preemptions(count, false);
+		const bool test_first = this->test_goes_first(this->snapshot_rounds++);
+		for (size_t turn = 0; turn < 2; ++turn) {
+			const size_t side = ((turn == 0) == test_first) ? 0 : 1;
+			Test* test = (side == 0) ? this->test : this->comparative;
+			Test* other = (side == 0) ? this->comparative : this->test;
+			const uint64_t batch =
+				(side == 0) ? this->batch_test : this->batch_comparative;
+
+			const uint64_t start = steady_now();
+			const bool measured = this->in_snapshot(
+				[&](PipeWriter& writer) {
+					for (uint64_t i = 0; i < count; ++i) {
+						this->migrated = false;
+						this->preempted = false;
+						const uint64_t measurement = this->measure(test, batch);
+						char tag = RECORD_SAMPLE;
+						if (this->migrated) {
+							tag = RECORD_MIGRATED;
+						} else if (this->preempted) {
+							tag = RECORD_PREEMPTED;
+						}
+						writer.write(tag, measurement);
+					}
+					return true;
+				},
+				[&](char tag, uint64_t value) {
+					if (tag == RECORD_MIGRATED) {
+						migrations[measurements[side].size()] = true;
+					} else if (tag == RECORD_PREEMPTED) {
+						preemptions[measurements[side].size()] = true;
+					}
+					measurements[side].push_back(value);
+				});
+			if (!measured || measurements[side].size() != count) {
+				test->postmortem();
+				other->post();
+				return false;
+			}
+
+			// Whatever time wasn't spent measuring went on the snapshot.
+			double measured_ns = 0;
+			for (uint64_t measurement : measurements[side]) {
+				measured_ns += this->results.get_calibration().to_ns(
+					static_cast<double>(measurement) * batch);
+			}
+			const double elapsed_ns = steady_now() - start;
+			(side == 0 ? this->reset_a : this->reset_b)
+				.add(std::max(elapsed_ns - measured_ns, 0.0) / count);
+		}
+
+		for (uint64_t i = 0; i < count; ++i) {
+			this->snapshot_pairs.push_back({measurements[0][i],
+											measurements[1][i],
+											migrations[i],
+											preemptions[i]});
+		}
+		return true;
+	}
+
+	/* Run something in a copy-on-write snapshot of this process, which
+	 * writes values back to us. Nothing it does touches our fixtures.
+	 * A snapshot gets as long as an isolated benchmark to finish.
+	 * \param body What the snapshot runs, returning true if it succeeded
+	 * \param on_value What to do with each value the snapshot writes,
+	 * given its tag
+	 * \return true if the snapshot succeeded, else false
+	 */
+	bool in_snapshot(const std::function<bool(PipeWriter&)>& body,
+					 const std::function<void(char, uint64_t)>& on_value)
+	{
+		ChildProcess child;
+		if (!child.spawn([&body](int fd) {
+				PipeWriter writer(fd);
+				const bool succeeded = body(writer);
+				return (writer.flush() && succeeded) ? 0 : 1;
+			})) {
+			return false;
+		}
+		// A snapshot that hangs is killed, and fails like one that crashed.
+		std::vector<ChildProcess*> children = {&child};
+		ChildProcess::read_all(
+			children,
+			options.isolation_timeout_ns,
+			[&](size_t, char tag, const std::string& payload) {
+				uint64_t value;
+				const bool sample = (tag == RECORD_SAMPLE ||
+									 tag == RECORD_MIGRATED ||
+									 tag == RECORD_PREEMPTED);
+				if (sample && read_record(payload, value)) {
+					on_value(tag, value);
+				}
+			});
+		return child.wait().succeeded;
+	}
+
+	/* Check that a test runs, timing its first run. Snapshots keep the
+	 * fixture pristine by doing this in a snapshot too.
+	 * \param test The test to run
+	 * \param first_run_ns [out] How long the first run took
+	 * \return true if the test ran, false if it failed
+	 */
+	bool validate(Test* test, uint64_t& first_run_ns)
+	{
+		auto first_run = [&]() {
+			const uint64_t start = steady_now();
+			const bool ran = test->run_optimized();
+			first_run_ns = steady_now() - start;
+			return ran;
+		};
+		if (options.reset != Reset::snapshot) {
+			return first_run();
+		}
+		return this->in_snapshot(
+			[&](PipeWriter& writer) {
+				const bool ran = first_run();
+				writer.write(RECORD_SAMPLE, first_run_ns);
+				return ran;
+			},
+			[&](char, uint64_t value) { first_run_ns = value; });
+	}
+
+	/* Find the batch size for a test, as find_batch_size() does. With
+	 * snapshots, this happens in a snapshot, to keep the fixture pristine.
+	 * \param test The test to size a batch for
+	 * \param target_ticks The target duration of one measurement, in ticks
+	 * \return the batch size, or 0 if the test's janitor() failed
+	 */
+	uint64_t size_batch(Test* test, double target_ticks)
+	{
+		if (options.reset != Reset::snapshot) {
+			return this->find_batch_size(test, target_ticks);
+		}
+		uint64_t batch = 0;
+		this->in_snapshot(
+			[&](PipeWriter& writer) {
+				const uint64_t found =
+					this->find_batch_size(test, target_ticks);
+				writer.write(RECORD_SAMPLE, found);
+				return found != 0;
+			},
+			[&](char, uint64_t value) { batch = value; });
+		return batch;
+	}
+
+	/* Run both tests in pairs, as they will be sampled, until each one's
+	 * measurements settle or warmup runs out of time.
+	 * \param test [in,out] How the test warmed up
+	 * \param comparative [in,out] How the comparative warmed up
+	 * \return true if warmup finished, false if a janitor failed
+	 */
+	bool warm_up(WarmupResult& test, WarmupResult& comparative)
+	{
+		WarmupResult sides[2] = {test, comparative};
+		const uint64_t batches[2] = {this->batch_test, this->batch_comparative};
+		this->order_rng.seed(options.seed);
+		const bool warmed = this->settle(
+			[this](uint64_t pair, uint64_t* measurements) {
+				return this->measure_pair(
+					pair, measurements[0], measurements[1]);
+			},
+			batches,
+			sides,
+			2);
+		test = sides[0];
+		comparative = sides[1];
+		return warmed;
+	}
+
+	/* Measure one or both sides until each one's measurements settle or
+	 * warmup runs out of time.
+	 * \param measure Takes the index of a pair and measures each side
+	 * into an array, returning false if a janitor failed
+	 * \param batches The batch size of each side
+	 * \param warmups [in,out] How each side warmed up
+	 * \param sides How many sides there are, 1 or 2
+	 * \return true if warmup finished, false if a janitor failed
+	 */
+	template<typename Measure>
+	bool settle(Measure measure,
+				const uint64_t* batches,
+				WarmupResult* warmups,
+				size_t sides)
+	{
+		std::vector<SteadyStateDetector> detectors(
+			sides,
+			SteadyStateDetector(options.warmup_window,
+								options.warmup_tolerance));
+		const uint64_t start = steady_now();
+		for (uint64_t pair = 0;; ++pair) {
+			uint64_t measurements[2];
+			if (!measure(pair, measurements)) {
+				return false;
+			}
+			const uint64_t elapsed = steady_now() - start;
+			auto record = [&](size_t side) {
+				warmups[side].iterations = (pair + 1) * batches[side];
+				warmups[side].duration_ns = elapsed;
+				warmups[side].steady_median = detectors[side].get_median();
+			};
+
+			// Note when each side first settles.
+			bool steady = true;
+			for (size_t side = 0; side < sides; ++side) {
+				if (!warmups[side].steady &&
+					detectors[side].add(measurements[side])) {
+					warmups[side].steady = true;
+					record(side);
+				}
+				steady = steady && warmups[side].steady;
+			}
+
+			if (elapsed < options.warmup_min_ns) {
+				continue;
+			}
+			if (steady) {
+				return true;
+			}
+			if (elapsed >= options.warmup_max_ns) {
+				// Whatever hasn't settled warmed up for the whole time.
+				for (size_t side = 0; side < sides; ++side) {
+					if (!warmups[side].steady) {
+						record(side);
+					}
+				}
+				return true;
+			}
+		}
+	}
+
+	/* Take a short pilot sample of both tests, and work out how many
+	 * pairs the verdict's test needs to detect the difference asked for.
+	 * The pilot's samples are not part of the result.
+	 * \param budget [in,out] The budget, whose iteration count is replaced
+	 * if the options ask for it
+	 * \return true if the pilot ran, false if a janitor failed
+	 */
+	bool pilot(RunBudget& budget)
+	{
+		StreamingStats stats_a, stats_b, stats_diff;
+		this->order_rng.seed(options.seed);
+		for (uint64_t pair = 0; pair < options.pilot_samples; ++pair) {
+			uint64_t measurement_a, measurement_b;
+			if (!this->measure_pair(pair, measurement_a, measurement_b)) {
+				return false;
+			}
+			stats_a.add(measurement_a);
+			stats_b.add(measurement_b);
+			stats_diff.add(static_cast<double>(measurement_a) -
+						   static_cast<double>(measurement_b));
+		}
+
+		PowerAdvice advice;
+		advice.pilot_samples = options.pilot_samples;
+		advice.mean_a = stats_a.mean();
+		advice.mean_b = stats_b.mean();
+		advice.relative_difference = options.detectable_difference;
+		advice.power = options.power;
+		advice.alpha = options.alpha;
+		// Only the paired test sees the differences; the others see A and B.
+		advice.std_dev = (options.verdict_method == VerdictMethod::paired_t)
+							 ? stats_diff.std_dev()
+							 : sqrt(stats_a.variance() + stats_b.variance());
+		advice.required_samples = required_sample_size(
+			options.verdict_method,
+			advice.std_dev,
+			options.detectable_difference * advice.mean_b,
+			options.alpha,
+			options.power);
+
+		if (options.apply_pilot && advice.required_samples > 0) {
+			budget.iterations =
+				std::min(advice.required_samples, options.pilot_max_iterations);
+			advice.applied = true;
+		}
+		this->results.set_power_advice(advice);
+		return true;
+	}
+
+	/* Decide which side of a pair is measured first.
+	 * \param pair The index of the pair of measurements
+	 * \return true if the test goes first, false if the comparative does
+	 */
+	bool test_goes_first(uint64_t pair)
+	{
+		switch (this->options.interleave) {
+			case Interleave::alternating:
+				// AB BA AB BA...
+				return (pair % 2) == 0;
+			case Interleave::abba:
+				// AB BA BA AB, cancelling linear drift within each block.
+				return ((pair % 4) == 0) || ((pair % 4) == 3);
+			case Interleave::random:
+				return (this->order_rng() & 1) == 0;
+			case Interleave::sequential:
+				[[fallthrough]];
+			default:
+				return true;
+		}
+	}
+
+	/* Find how many runs of a test make one measurement last at least
+	 * the target duration, by doubling the batch until it does.
+	 * \param test The test to size a batch for
+	 * \param target_ticks The target duration of one measurement, in ticks
+	 * \return the batch size, or 0 if the test's janitor() failed
+	 */
+	uint64_t find_batch_size(Test* test, double target_ticks)
+	{
+		// A fixed batch size was requested.
+		if (this->options.batch_size != 0) {
+			return this->options.batch_size;
+		}
+
+		uint64_t batch = 1;
+		while (batch < this->options.batch_size_max) {
+			if (!test->janitor()) {
+				return 0;
+			}
+			// Take the best of a few, so one interrupt doesn't shrink N.
+			uint64_t best =
+				this->overhead.subtract(clock(test, this->source, batch));
+			for (uint8_t i = 0; i < 2; ++i) {
+				best = std::min(best,
+								this->overhead.subtract(
+									clock(test, this->source, batch)));
+			}
+			if ((double)best >= target_ticks) {
+				break;
+			}
+			batch *= 2;
+		}
+		return std::min(batch, this->options.batch_size_max);
+	}
+
+	/* Convert a batch measurement into the time for one run.
+	 * \param ticks The measurement of the whole batch
+	 * \param batch The number of runs in the batch
+	 * \return the time of one run, rounded to the nearest tick
+	 */
+	static uint64_t per_run(uint64_t ticks, uint64_t batch)
+	{
+		return (batch <= 1) ? ticks : (ticks + batch / 2) / batch;
+	}
 };
 
 /* Runs the given item, to be used by the runner
@@ -200,21 +1453,22 @@ template<> class Runner<TestSuite>
 {
 protected:
 	TestSuite* suite;
-	uint16_t iterations;
+	RunBudget budget;
 
 public:
 	/* Ctor To run either a suite or a test
 	 * \param suite The suite to run
-	 * \param iterations The number of time to run the suite
+	 * \param budget How many times (or how long) to run the suite
 	 */
-	explicit Runner(TestSuite* suite, uint16_t iterations = 1)
-	: suite(suite), iterations(iterations){};
+	explicit Runner(TestSuite* suite, RunBudget budget = RunBudget())
+	: suite(suite), budget(budget){};
 
 	/* Runs the suite a given amount of time
 	 */
 	void run()
 	{
-		for (uint16_t i = 0; i <= iterations; i++) {
+		for (BudgetTracker tracker(this->budget); !tracker.done();
+			 tracker.count()) {
 			for (auto suite_pair : suite->runnables) {
 				// TODO: Do something with the result (i.e, generate a report)
 				bool res = std::visit([](auto arg) { return run_item(arg); },
@@ -0,0 +1,151 @@
+/** Sequential Test [Goldilocks]
+ * Version: 2.0
+ *
+ * Stops a comparison early, once its verdict is settled.
+ *
+ * Author(s): Wilfrantz DEDE, Manuel Mateo, Jason C. McDonald
+ */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_SEQUENTIAL_TEST_HPP
+#define GOLDILOCKS_SEQUENTIAL_TEST_HPP
+
+#include <cstdint>
+
+/// When a comparison may stop before its budget is used up.
+enum class EarlyStop {
+	/// Always use the whole budget.
+	none,
+	/// Stop once the difference is significant.
+	significance,
+	/// Stop once the difference is known precisely, significant or not.
+	precision,
+	/// Stop at whichever of the above comes first.
+	either
+};
+
+/** Watches the paired differences of a comparison as they arrive, and
+ * decides when to stop. Every few pairs it takes a look at the running
+ * mean difference and its standard error.
+ *
+ * Looking repeatedly gives chance more chances to look significant.
+ * To allow for this, look k is only allowed alpha * 6 / (pi^2 * k^2) of
+ * the error rate. These shares add up to alpha over any number of looks,
+ * so the whole run stays within alpha (a Bonferroni bound). Confidence
+ * intervals for the precision target are widened the same way.*/
+class SequentialTest
+{
+protected:
+	/// When to stop.
+	EarlyStop mode;
+
+	/// The overall significance level.
+	double alpha;
+
+	/** The confidence interval half-width to stop at, as a fraction of
+	 * the comparative's mean.*/
+	double precision;
+
+	/// How many pairs to take between looks.
+	uint64_t interval;
+
+	/// The number of pairs so far.
+	uint64_t count = 0;
+
+	/// The running mean difference (A - B).
+	double mean_d = 0;
+
+	/// The running sum of squared deviations of the differences.
+	double m2_d = 0;
+
+	/// The running mean of the comparative (B).
+	double mean_b = 0;
+
+	/// The number of looks taken so far.
+	uint64_t looks = 0;
+
+	/// Why the test stopped, or none if it hasn't.
+	EarlyStop reason = EarlyStop::none;
+
+	/**Take a look at the running comparison.
+	 * \return true if the comparison should stop, else false
+	 */
+	bool look();
+
+public:
+	/* Ctor
+	 * \param mode When to stop
+	 * \param alpha The overall significance level, e.g. 0.05
+	 * \param precision The interval half-width to stop at, as a fraction
+	 * of the comparative's mean, e.g. 0.01
+	 * \param interval How many pairs to take between looks
+	 */
+	SequentialTest(EarlyStop mode,
+				   double alpha,
+				   double precision,
+				   uint64_t interval);
+
+	/**Add a pair of measurements.
+	 * \param the measurement of the test (A)
+	 * \param the measurement of the comparative (B)
+	 * \return true if the comparison should stop, else false
+	 */
+	bool add(uint64_t measurement_a, uint64_t measurement_b)
+	{
+		++this->count;
+		const double d = static_cast<double>(measurement_a) -
+						 static_cast<double>(measurement_b);
+		const double delta = d - this->mean_d;
+		this->mean_d += delta / this->count;
+		this->m2_d += delta * (d - this->mean_d);
+		this->mean_b += (measurement_b - this->mean_b) / this->count;
+
+		if (this->mode == EarlyStop::none ||
+			this->count % this->interval != 0) {
+			return false;
+		}
+		return this->look();
+	}
+
+	/// \return why the test stopped, or none if it hasn't
+	EarlyStop stopped() const { return this->reason; }
+
+	/// \return the number of looks taken
+	uint64_t get_looks() const { return this->looks; }
+};
+
+#endif  // GOLDILOCKS_SEQUENTIAL_TEST_HPP
@@ -0,0 +1,271 @@
+/** Statistics [Goldilocks]
+ * Version: 2.0
+ *
+ * Distributions and hypothesis tests for comparing benchmark results.
+ *
+ * Author(s): Wilfrantz DEDE, Manuel Mateo, Jason C. McDonald
+ */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_STATISTICS_HPP
+#define GOLDILOCKS_STATISTICS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/// The hypothesis test used to compare a test (A) against a comparative (B).
+enum class VerdictMethod {
+	/// Student's t-test on the paired differences of interleaved runs.
+	paired_t,
+	/// Welch's unequal-variance t-test on the two series.
+	welch_t,
+	/// The Mann-Whitney U (rank-sum) test on the two series.
+	mann_whitney
+};
+
+/// How outliers are told apart from the rest of a series.
+enum class OutlierMethod {
+	/// Keep every sample.
+	none,
+	/// Tukey's fences, k interquartile ranges beyond the quartiles.
+	tukey,
+	/** k median absolute deviations (scaled to match the standard
+	 * deviation of normal data) either side of the median.*/
+	mad,
+	/// Trim a fixed percentage of samples off each end.
+	trim
+};
+
+/** Which samples count as outliers, and so are left out of the adjusted
+ * statistics. Samples beyond the inner fences are minor outliers, and
+ * those beyond the outer fences (twice as far out) are major outliers.
+ * Trimmed samples are all minor outliers.*/
+struct OutlierPolicy {
+	/// How outliers are found.
+	OutlierMethod method = OutlierMethod::tukey;
+
+	/** How far out the inner fences are: in interquartile ranges for
+	 * Tukey, in scaled MADs for MAD, or the percentage trimmed off each
+	 * end for trimming.*/
+	double k = 1.5;
+
+	/// \return a policy that keeps every sample
+	static OutlierPolicy none() { return {OutlierMethod::none, 0}; }
+
+	/// \return Tukey's fences, k interquartile ranges out
+	static OutlierPolicy tukey(double k = 1.5)
+	{
+		return {OutlierMethod::tukey, k};
+	}
+
+	/// \return fences k scaled median absolute deviations out
+	static OutlierPolicy mad(double k = 3) { return {OutlierMethod::mad, k}; }
+
+	/// \return a policy that trims a percentage off each end
+	static OutlierPolicy trim(double percent = 5)
+	{
+		return {OutlierMethod::trim, percent};
+	}
+};
+
+/** The outcome of a hypothesis test of whether A and B differ.
+ * Differences are always taken as A - B, so a negative estimate means
+ * the test (A) was faster.*/
+struct HypothesisTest {
+	/// The test that was actually used.
+	VerdictMethod method = VerdictMethod::paired_t;
+
+	/** The estimated difference: the mean difference for the t-tests,
+	 * or the Hodges-Lehmann shift for Mann-Whitney U.*/
+	double estimate = 0;
+
+	/// The test statistic (t, or U).
+	double statistic = 0;
+
+	/// The degrees of freedom of the t statistic (0 for Mann-Whitney U).
+	double df = 0;
+
+	/// The two-sided p-value.
+	double p = 1;
+
+	/// The confidence level of the interval, e.g. 0.95.
+	double confidence = 0;
+
+	/// The lower bound of the confidence interval of the difference.
+	double ci_low = 0;
+
+	/// The upper bound of the confidence interval of the difference.
+	double ci_high = 0;
+
+	/** The standardized effect size: Cohen's d for the t-tests, or the
+	 * rank-biserial correlation (from -1 to 1) for Mann-Whitney U.*/
+	double effect_size = 0;
+};
+
+/** What a pilot run found about how many samples a comparison needs.*/
+struct PowerAdvice {
+	/// How many pairs the pilot took, or 0 if there was no pilot.
+	uint64_t pilot_samples = 0;
+
+	/// The mean of the test (A) in the pilot, in ticks.
+	double mean_a = 0;
+
+	/// The mean of the comparative (B) in the pilot, in ticks.
+	double mean_b = 0;
+
+	/** The spread the verdict's test sees, in ticks: the standard
+	 * deviation of the differences for paired tests, or of A - B as
+	 * independent series otherwise.*/
+	double std_dev = 0;
+
+	/// The smallest difference to detect, as a fraction of B's mean.
+	double relative_difference = 0;
+
+	/// The chance of detecting that difference, e.g. 0.8.
+	double power = 0;
+
+	/// The significance level, e.g. 0.05.
+	double alpha = 0;
+
+	/// The pairs needed, or 0 if the pilot couldn't tell.
+	uint64_t required_samples = 0;
+
+	/// Whether the requirement replaced the budget's iteration count.
+	bool applied = false;
+};
+
+/**Get a printable name for a verdict method.
+ * \param the verdict method
+ * \return the name of the method
+ */
+const char* verdict_method_name(VerdictMethod);
+
+/**Get a printable name for an outlier method.
+ * \param the outlier method
+ * \return the name of the method
+ */
+const char* outlier_method_name(OutlierMethod);
+
+/**The cumulative distribution function of the standard normal.
+ * \param the z score
+ * \return P(Z <= z)
+ */
+double normal_cdf(double);
+
+/**The inverse of the standard normal CDF.
+ * \param the probability, in (0, 1)
+ * \return the z score with that cumulative probability
+ */
+double normal_quantile(double);
+
+/**The regularized incomplete beta function.
+ * \param x, in [0, 1]
+ * \param a, greater than 0
+ * \param b, greater than 0
+ * \return I_x(a, b)
+ */
+double incomplete_beta(double, double, double);
+
+/**The two-sided tail probability of Student's t distribution.
+ * \param the t statistic
+ * \param the degrees of freedom
+ * \return P(|T| >= |t|)
+ */
+double student_t_two_sided(double, double);
+
+/**The critical value of Student's t distribution for a two-sided test.
+ * \param the significance level, e.g. 0.05
+ * \param the degrees of freedom
+ * \return the t with P(|T| >= t) equal to the significance level
+ */
+double student_t_critical(double, double);
+
+/**Student's t-test on paired differences.
+ * \param the mean difference
+ * \param the standard deviation of the differences
+ * \param the number of pairs
+ * \param the significance level, e.g. 0.05
+ * \return the outcome of the test
+ */
+HypothesisTest paired_t_test(double, double, uint64_t, double);
+
+/**Welch's unequal-variance t-test on two independent series.
+ * \param the mean of A
+ * \param the standard deviation of A
+ * \param the size of A
+ * \param the mean of B
+ * \param the standard deviation of B
+ * \param the size of B
+ * \param the significance level, e.g. 0.05
+ * \return the outcome of the test
+ */
+HypothesisTest welch_t_test(double,
+							double,
+							uint64_t,
+							double,
+							double,
+							uint64_t,
+							double);
+
+/**The Mann-Whitney U test on two independent series, using the normal
+ * approximation with corrections for ties and continuity. The interval
+ * is found by inverting the test over shifts of A. This sorts both
+ * series in place.
+ * \param the series A
+ * \param the size of A
+ * \param the series B
+ * \param the size of B
+ * \param the significance level, e.g. 0.05
+ * \return the outcome of the test
+ */
+HypothesisTest
+	mann_whitney_u_test(uint64_t*, size_t, uint64_t*, size_t, double);
+
+/**Find how many samples a hypothesis test needs to detect a
+ * difference, by the normal approximation with a correction for
+ * estimating the variance.
+ * \param the hypothesis test that will be used
+ * \param the spread the test sees (see PowerAdvice::std_dev)
+ * \param the smallest difference to detect, in the same units
+ * \param the significance level, e.g. 0.05
+ * \param the chance of detecting the difference, e.g. 0.8
+ * \return the number of samples (pairs) needed, or 0 if the difference
+ * is not positive
+ */
+uint64_t required_sample_size(VerdictMethod, double, double, double, double);
+
+#endif  // GOLDILOCKS_STATISTICS_HPP
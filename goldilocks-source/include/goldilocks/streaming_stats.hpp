@@ -0,0 +1,262 @@
+/** Streaming Statistics [Goldilocks]
+ * Version: 2.0
+ *
+ * Constant-memory statistics for very long benchmark runs.
+ *
+ * Author(s): Wilfrantz DEDE, Manuel Mateo, Jason C. McDonald
+ */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_STREAMING_STATS_HPP
+#define GOLDILOCKS_STREAMING_STATS_HPP
+
+#include <cstdint>
+
+/** Estimates a single quantile of a stream without storing it, using
+ * the P-squared algorithm (Jain & Chlamtac, 1985). Five markers track
+ * the minimum, the maximum, the quantile, and the points halfway to it
+ * on either side; their heights are adjusted with piecewise-parabolic
+ * interpolation as observations arrive.*/
+class P2Quantile
+{
+protected:
+	/// The quantile being estimated, in [0, 1].
+	double p;
+
+	/// The number of observations so far.
+	uint64_t count = 0;
+
+	/// Marker heights.
+	double q[5] = {0, 0, 0, 0, 0};
+
+	/// Actual marker positions (1-based).
+	double n[5] = {1, 2, 3, 4, 5};
+
+	/// Desired marker positions.
+	double np[5] = {0, 0, 0, 0, 0};
+
+	/// Increments of the desired marker positions.
+	double dn[5] = {0, 0, 0, 0, 0};
+
+	/**Predict a marker's new height with the P-squared parabola.
+	 * \param the marker index
+	 * \param the direction to move the marker (-1 or 1)
+	 * \return the predicted height
+	 */
+	double parabolic(int i, int d) const;
+
+	/**Predict a marker's new height linearly, for when the parabola
+	 * would take the markers out of order.
+	 * \param the marker index
+	 * \param the direction to move the marker (-1 or 1)
+	 * \return the predicted height
+	 */
+	double linear(int i, int d) const;
+
+public:
+	/* Ctor
+	 * \param p The quantile to estimate, in [0, 1]
+	 */
+	explicit P2Quantile(double p);
+
+	/**Add an observation.
+	 * \param the observation
+	 */
+	void add(double x);
+
+	/**Get the current estimate of the quantile.
+	 * Exact for the first five observations.
+	 * \return the estimate, or 0 if there are no observations
+	 */
+	double estimate() const;
+};
+
+/** Summary statistics of a stream of samples, in constant memory.
+ * Mean and variance are exact (Welford's method), as are the minimum and
+ * maximum. Quartiles are P-squared estimates, and outliers are judged
+ * against Tukey fences built from the quartile estimates at the time each
+ * sample arrives, so both are approximate early in a run.*/
+class StreamingStats
+{
+protected:
+	/** How many interquartile ranges out the inner fences are, or
+	 * infinity to never judge a sample an outlier.*/
+	double fence_k;
+
+	/// The number of samples.
+	uint64_t count = 0;
+
+	/// The running mean.
+	double mean_val = 0;
+
+	/// The running sum of squared deviations from the mean.
+	double m2 = 0;
+
+	/// The minimum sample.
+	double min_val = 0;
+
+	/// The maximum sample.
+	double max_val = 0;
+
+	/// The lower quartile estimator.
+	P2Quantile q1_est;
+
+	/// The median estimator.
+	P2Quantile median_est;
+
+	/// The upper quartile estimator.
+	P2Quantile q3_est;
+
+	/// The 99th percentile estimator.
+	P2Quantile p99_est;
+
+	/// The 99.9th percentile estimator.
+	P2Quantile p999_est;
+
+	/// The 99.99th percentile estimator.
+	P2Quantile p9999_est;
+
+	/// The number of low minor outliers.
+	uint64_t low_out_minor = 0;
+
+	/// The number of low major outliers.
+	uint64_t low_out_major = 0;
+
+	/// The number of upper minor outliers.
+	uint64_t upp_out_minor = 0;
+
+	/// The number of upper major outliers.
+	uint64_t upp_out_major = 0;
+
+	/// The number of non-outlier samples.
+	uint64_t count_adj = 0;
+
+	/// The running mean of non-outlier samples.
+	double mean_adj_val = 0;
+
+	/// The running sum of squared deviations of non-outlier samples.
+	double m2_adj = 0;
+
+	/// The minimum non-outlier sample.
+	double min_adj_val = 0;
+
+	/// The maximum non-outlier sample.
+	double max_adj_val = 0;
+
+public:
+	/* Ctor
+	 * \param fence_k How many interquartile ranges out the inner fences
+	 * are (the outer fences are twice as far), or infinity for no outliers
+	 */
+	explicit StreamingStats(double fence_k = 1.5);
+
+	/// \return how many interquartile ranges out the inner fences are
+	double get_fence_k() const { return this->fence_k; }
+
+	/**Add a sample.
+	 * \param the sample
+	 */
+	void add(double x);
+
+	/// \return the number of samples
+	uint64_t size() const { return this->count; }
+
+	/// \return the mean
+	double mean() const { return this->mean_val; }
+
+	/// \return the sample variance
+	double variance() const
+	{
+		return (this->count > 1) ? this->m2 / (this->count - 1) : 0;
+	}
+
+	/// \return the sample standard deviation
+	double std_dev() const;
+
+	/// \return the minimum sample
+	double min() const { return this->min_val; }
+
+	/// \return the maximum sample
+	double max() const { return this->max_val; }
+
+	/// \return the estimated lower quartile
+	double q1() const { return this->q1_est.estimate(); }
+
+	/// \return the estimated median
+	double median() const { return this->median_est.estimate(); }
+
+	/// \return the estimated upper quartile
+	double q3() const { return this->q3_est.estimate(); }
+
+	/// \return the estimated 99th percentile
+	double p99() const { return this->p99_est.estimate(); }
+
+	/// \return the estimated 99.9th percentile
+	double p999() const { return this->p999_est.estimate(); }
+
+	/// \return the estimated 99.99th percentile
+	double p9999() const { return this->p9999_est.estimate(); }
+
+	/// \return the number of low minor outliers
+	uint64_t low_minor() const { return this->low_out_minor; }
+
+	/// \return the number of low major outliers
+	uint64_t low_major() const { return this->low_out_major; }
+
+	/// \return the number of upper minor outliers
+	uint64_t upper_minor() const { return this->upp_out_minor; }
+
+	/// \return the number of upper major outliers
+	uint64_t upper_major() const { return this->upp_out_major; }
+
+	/// \return the number of non-outlier samples
+	uint64_t size_adj() const { return this->count_adj; }
+
+	/// \return the mean of non-outlier samples
+	double mean_adj() const { return this->mean_adj_val; }
+
+	/// \return the sample standard deviation of non-outlier samples
+	double std_dev_adj() const;
+
+	/// \return the minimum non-outlier sample
+	double min_adj() const { return this->min_adj_val; }
+
+	/// \return the maximum non-outlier sample
+	double max_adj() const { return this->max_adj_val; }
+};
+
+#endif  // GOLDILOCKS_STREAMING_STATS_HPP
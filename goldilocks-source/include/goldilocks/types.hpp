@@ -54,7 +54,7 @@ public:
 
 // NOTE: We don't need to represent a void return; it never needs to be tested!
 
-std::ostream& operator<<(std::ostream& out, const Nothing&)
+inline std::ostream& operator<<(std::ostream& out, const Nothing&)
 {
 	out << "[Nothing]";
 	return out;
@@ -0,0 +1,118 @@
+/** Warmup [Goldilocks]
+ * Version: 2.0
+ *
+ * Detects when a test has warmed up to a steady state.
+ *
+ * Author(s): Wilfrantz DEDE, Manuel Mateo, Jason C. McDonald
+ */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_WARMUP_HPP
+#define GOLDILOCKS_WARMUP_HPP
+
+#include <cstdint>
+#include <vector>
+
+/// How one side of a benchmark warmed up.
+struct WarmupResult {
+	/// How long the first (validation) run of the test took, in nanoseconds.
+	uint64_t first_run_ns = 0;
+
+	/// How many runs of the test it took to reach a steady state.
+	uint64_t iterations = 0;
+
+	/// How long it took to reach a steady state, in nanoseconds.
+	uint64_t duration_ns = 0;
+
+	/// The median measurement once steady, in ticks.
+	uint64_t steady_median = 0;
+
+	/// Whether a steady state was reached before warmup ran out of time.
+	bool steady = false;
+};
+
+/** Watches a test's measurements during warmup, and decides when they
+ * have settled. Measurements are taken in windows; the test is steady
+ * once the medians of the last few windows agree to within a tolerance.
+ * Medians shrug off the odd interruption, which would otherwise keep
+ * the test from ever looking steady.*/
+class SteadyStateDetector
+{
+protected:
+	/// How many measurements go in each window.
+	uint32_t window;
+
+	/// How far apart (as a fraction) window medians may be when steady.
+	double tolerance;
+
+	/// The measurements of the window in progress.
+	std::vector<uint64_t> current;
+
+	/// The medians of the most recent windows, oldest first.
+	std::vector<uint64_t> medians;
+
+	/// Whether the measurements have settled.
+	bool steady = false;
+
+public:
+	/// How many window medians must agree for a steady state.
+	static constexpr uint32_t STABLE_WINDOWS = 3;
+
+	/* Ctor
+	 * \param window How many measurements go in each window
+	 * \param tolerance How far apart (as a fraction) window medians may
+	 * be once steady, e.g. 0.02
+	 */
+	SteadyStateDetector(uint32_t window, double tolerance);
+
+	/**Add a measurement.
+	 * \param the measurement
+	 * \return true if the measurements have settled, else false
+	 */
+	bool add(uint64_t measurement);
+
+	/// \return true if the measurements have settled, else false
+	bool is_steady() const { return this->steady; }
+
+	/// \return the median of the last complete window, or 0 if none
+	uint64_t get_median() const
+	{
+		return this->medians.empty() ? 0 : this->medians.back();
+	}
+};
+
+#endif  // GOLDILOCKS_WARMUP_HPP
@@ -0,0 +1,131 @@
+#include "goldilocks/affinity.hpp"
+
+#include <cstring>  // memcpy
+
+#include "goldilocks/clock.hpp"
+
+#if GOLDILOCKS_HAS_AFFINITY
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
+
+#if GOLDILOCKS_HAS_TSC && GOLDILOCKS_HAS_AFFINITY
+#include <x86intrin.h>
+#endif
+
+int current_cpu()
+{
+#if GOLDILOCKS_HAS_TSC && GOLDILOCKS_HAS_AFFINITY
+	if (clock_source_available(ClockSource::tsc)) {
+		unsigned int aux;
+		__rdtscp(&aux);
+		// The low 12 bits are the CPU; the rest are the NUMA node.
+		return static_cast<int>(aux & 0xFFF);
+	}
+#endif
+#if GOLDILOCKS_HAS_AFFINITY
+	return sched_getcpu();
+#else
+	return -1;
+#endif
+}
+
+uint64_t preemption_count()
+{
+#if GOLDILOCKS_HAS_AFFINITY
+	struct rusage usage;
+	if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+		return static_cast<uint64_t>(usage.ru_nivcsw);
+	}
+#endif
+	return 0;
+}
+
+bool ThreadPlacement::pin(int cpu)
+{
+	if (cpu == this->pinned) {
+		return true;
+	}
+#if GOLDILOCKS_HAS_AFFINITY
+	if (cpu < 0 || cpu >= CPU_SETSIZE) {
+		return false;
+	}
+	// Remember where the thread could run, before we first pin it.
+	if (this->saved_affinity.empty()) {
+		cpu_set_t saved;
+		if (sched_getaffinity(0, sizeof(saved), &saved) != 0) {
+			return false;
+		}
+		this->saved_affinity.resize(sizeof(saved));
+		memcpy(this->saved_affinity.data(), &saved, sizeof(saved));
+	}
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+		return false;
+	}
+	this->pinned = cpu;
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool ThreadPlacement::make_realtime(int priority)
+{
+#if GOLDILOCKS_HAS_AFFINITY
+	if (!this->rescheduled) {
+		sched_param saved;
+		this->saved_policy = sched_getscheduler(0);
+		if (this->saved_policy < 0 || sched_getparam(0, &saved) != 0) {
+			return false;
+		}
+		this->saved_priority = saved.sched_priority;
+	}
+
+	sched_param param;
+	param.sched_priority = priority;
+	if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+		return false;
+	}
+	this->rescheduled = true;
+	return true;
+#else
+	(void)priority;
+	return false;
+#endif
+}
+
+bool ThreadPlacement::lock_memory()
+{
+#if GOLDILOCKS_HAS_AFFINITY
+	if (!this->locked && mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+		this->locked = true;
+	}
+	return this->locked;
+#else
+	return false;
+#endif
+}
+
+ThreadPlacement::~ThreadPlacement()
+{
+#if GOLDILOCKS_HAS_AFFINITY
+	if (this->locked) {
+		munlockall();
+	}
+	if (this->rescheduled) {
+		sched_param saved;
+		saved.sched_priority = this->saved_priority;
+		sched_setscheduler(0, this->saved_policy, &saved);
+	}
+	if (!this->saved_affinity.empty()) {
+		cpu_set_t saved;
+		memcpy(&saved, this->saved_affinity.data(), sizeof(saved));
+		sched_setaffinity(0, sizeof(saved), &saved);
+	}
+#endif
+}
@@ -0,0 +1,322 @@
+#include "goldilocks/alloc_tracker.hpp"
+
+#include <cstdlib>  // malloc, free, aligned_alloc
+#include <new>      // std::bad_alloc, std::align_val_t, std::nothrow_t
+
+#if GOLDILOCKS_TRACK_ALLOCATIONS && GOLDILOCKS_TRACK_MALLOC
+#include <cerrno>  // ENOMEM
+
+// glibc's own allocator, under the names it keeps for wrappers like ours.
+extern "C" {
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void* __libc_memalign(size_t, size_t);
+void __libc_free(void*);
+}
+#endif
+
+namespace {
+	/** How many times the calling thread has started tracking, and not
+	 * yet stopped. It is tracking while this is above 0.*/
+	thread_local uint32_t tracking = 0;
+
+	/// What the calling thread has allocated, over all its tracking.
+	thread_local AllocCounts counts;
+
+#if GOLDILOCKS_TRACK_ALLOCATIONS
+	/**Count an allocation, if the calling thread is tracking.
+	 * \param the block, or nullptr if the allocation failed
+	 * \param the size asked for, in bytes
+	 */
+	inline void note_allocation(const void* block, size_t size)
+	{
+		if (tracking > 0 && block != nullptr) {
+			++counts.allocations;
+			counts.bytes += size;
+		}
+	}
+
+	/**Count a free, if the calling thread is tracking.
+	 * \param the block, which may be nullptr
+	 */
+	inline void note_free(const void* block)
+	{
+		if (tracking > 0 && block != nullptr) {
+			++counts.frees;
+		}
+	}
+
+	/**Allocate a block, as malloc() does, without counting it.
+	 * \param the size, in bytes
+	 * \return the block, or nullptr if out of memory
+	 */
+	inline void* raw_allocate(size_t size)
+	{
+#if GOLDILOCKS_TRACK_MALLOC
+		return __libc_malloc(size);
+#else
+		return malloc(size);
+#endif
+	}
+
+	/**Allocate an aligned block, without counting it.
+	 * \param the alignment, a power of two
+	 * \param the size, in bytes
+	 * \return the block, or nullptr if out of memory
+	 */
+	inline void* raw_allocate_aligned(size_t align, size_t size)
+	{
+#if GOLDILOCKS_TRACK_MALLOC
+		return __libc_memalign(align, size);
+#else
+		// aligned_alloc() wants a whole number of alignments.
+		return aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+	}
+
+	/**Free a block, without counting it.
+	 * \param the block, which may be nullptr
+	 */
+	inline void raw_free(void* block)
+	{
+#if GOLDILOCKS_TRACK_MALLOC
+		__libc_free(block);
+#else
+		free(block);
+#endif
+	}
+
+	/**Allocate for operator new, calling the new-handler until it
+	 * succeeds, as the standard asks.
+	 * \param the size, in bytes
+	 * \param the alignment, or 0 for the default
+	 * \return the block, or nullptr if out of memory and there is no
+	 * new-handler left to try
+	 */
+	void* allocate(size_t size, size_t align)
+	{
+		// Every allocation must be unique, even an empty one.
+		if (size == 0) {
+			size = 1;
+		}
+		for (;;) {
+			void* block = (align == 0) ? raw_allocate(size)
+									   : raw_allocate_aligned(align, size);
+			if (block != nullptr) {
+				note_allocation(block, size);
+				return block;
+			}
+			std::new_handler handler = std::get_new_handler();
+			if (handler == nullptr) {
+				return nullptr;
+			}
+			handler();
+		}
+	}
+
+	/**Allocate for operator new, throwing if out of memory.
+	 * \param the size, in bytes
+	 * \param the alignment, or 0 for the default
+	 * \return the block
+	 * \throw std::bad_alloc if out of memory
+	 */
+	void* allocate_or_throw(size_t size, size_t align)
+	{
+		void* block = allocate(size, align);
+		if (block == nullptr) {
+			throw std::bad_alloc();
+		}
+		return block;
+	}
+
+	/**Allocate for a non-throwing operator new.
+	 * \param the size, in bytes
+	 * \param the alignment, or 0 for the default
+	 * \return the block, or nullptr if out of memory
+	 */
+	void* allocate_or_null(size_t size, size_t align) noexcept
+	{
+		try {
+			return allocate(size, align);
+		} catch (...) {
+			// A new-handler may throw std::bad_alloc.
+			return nullptr;
+		}
+	}
+
+	/**Free a block from operator new.
+	 * \param the block, which may be nullptr
+	 */
+	void release(void* block) noexcept
+	{
+		note_free(block);
+		raw_free(block);
+	}
+#endif
+}  // namespace
+
+bool AllocTracker::enabled() { return GOLDILOCKS_TRACK_ALLOCATIONS != 0; }
+
+AllocCounts AllocTracker::start()
+{
+	++tracking;
+	return counts;
+}
+
+AllocCounts AllocTracker::stop(const AllocCounts& mark)
+{
+	if (tracking > 0) {
+		--tracking;
+	}
+	AllocCounts since;
+	since.allocations = counts.allocations - mark.allocations;
+	since.frees = counts.frees - mark.frees;
+	since.bytes = counts.bytes - mark.bytes;
+	return since;
+}
+
+#if GOLDILOCKS_TRACK_ALLOCATIONS
+void* operator new(size_t size) { return allocate_or_throw(size, 0); }
+
+void* operator new[](size_t size) { return allocate_or_throw(size, 0); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate_or_null(size, 0);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate_or_null(size, 0);
+}
+
+void* operator new(size_t size, std::align_val_t align)
+{
+	return allocate_or_throw(size, static_cast<size_t>(align));
+}
+
+void* operator new[](size_t size, std::align_val_t align)
+{
+	return allocate_or_throw(size, static_cast<size_t>(align));
+}
+
+void* operator new(size_t size,
+				   std::align_val_t align,
+				   const std::nothrow_t&) noexcept
+{
+	return allocate_or_null(size, static_cast<size_t>(align));
+}
+
+void* operator new[](size_t size,
+					 std::align_val_t align,
+					 const std::nothrow_t&) noexcept
+{
+	return allocate_or_null(size, static_cast<size_t>(align));
+}
+
+void operator delete(void* block) noexcept { release(block); }
+
+void operator delete[](void* block) noexcept { release(block); }
+
+void operator delete(void* block, size_t) noexcept { release(block); }
+
+void operator delete[](void* block, size_t) noexcept { release(block); }
+
+void operator delete(void* block, const std::nothrow_t&) noexcept
+{
+	release(block);
+}
+
+void operator delete[](void* block, const std::nothrow_t&) noexcept
+{
+	release(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept
+{
+	release(block);
+}
+
+void operator delete[](void* block, std::align_val_t) noexcept
+{
+	release(block);
+}
+
+void operator delete(void* block, size_t, std::align_val_t) noexcept
+{
+	release(block);
+}
+
+void operator delete[](void* block, size_t, std::align_val_t) noexcept
+{
+	release(block);
+}
+
+void operator delete(void* block,
+					 std::align_val_t,
+					 const std::nothrow_t&) noexcept
+{
+	release(block);
+}
+
+void operator delete[](void* block,
+					   std::align_val_t,
+					   const std::nothrow_t&) noexcept
+{
+	release(block);
+}
+
+#if GOLDILOCKS_TRACK_MALLOC
+extern "C" {
+void* malloc(size_t size)
+{
+	void* block = __libc_malloc(size);
+	note_allocation(block, size);
+	return block;
+}
+
+void* calloc(size_t count, size_t size)
+{
+	void* block = __libc_calloc(count, size);
+	note_allocation(block, count * size);
+	return block;
+}
+
+void* realloc(void* block, size_t size)
+{
+	void* moved = __libc_realloc(block, size);
+	// Growing or shrinking in place is still a new block, as counted.
+	if (moved != nullptr || size == 0) {
+		note_free(block);
+	}
+	note_allocation(moved, size);
+	return moved;
+}
+
+void* aligned_alloc(size_t align, size_t size)
+{
+	void* block = __libc_memalign(align, size);
+	note_allocation(block, size);
+	return block;
+}
+
+int posix_memalign(void** out, size_t align, size_t size)
+{
+	void* block = __libc_memalign(align, size);
+	if (block == nullptr) {
+		return ENOMEM;
+	}
+	note_allocation(block, size);
+	*out = block;
+	return 0;
+}
+
+void free(void* block)
+{
+	note_free(block);
+	__libc_free(block);
+}
+}
+#endif
+#endif  // GOLDILOCKS_TRACK_ALLOCATIONS
@@ -1,205 +1,917 @@
 #include "goldilocks/benchmark_results.hpp"
 
-#include <algorithm>  // std::sort
-#include <cmath>      // sqrt
+#include <algorithm>  // std::nth_element, std::min_element, std::max_element
+#include <cmath>      // sqrt, llround, ceil, fabs, floor, isfinite
 
-void BenchmarkResult::finalize(const BenchmarkResult& result1,
-							   const BenchmarkResult& result2)
-{
-	// Sort the array.
-	std::sort(results.begin(), results.end());
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GOLDILOCKS_HAS_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define GOLDILOCKS_HAS_X86_SIMD 0
+#endif
+
+namespace {
+	/** The running totals of one fused pass over a series. Sums are taken
+	 * of each sample's difference from a shift close to the mean (such as
+	 * any one sample), so that the sum of squares doesn't lose the
+	 * variance to cancellation.*/
+	struct SeriesSums {
+		/// The exact sum of the samples.
+		uint64_t sum = 0;
+
+		/// The smallest sample.
+		uint64_t min = UINT64_MAX;
+
+		/// The largest sample.
+		uint64_t max = 0;
+
+		/// The sum of each sample's difference from the shift.
+		double dev = 0;
 
-	// Store the repetition count.
-	this->repeat = results.size();
+		/// The sum of each sample's squared difference from the shift.
+		double dev_sq = 0;
+	};
 
-	/* Calculate the accumulator (grand total).
-	 * For each item in the array...*/
-	for (uint64_t i = 0; i < this->repeat; i++) {
-		// Add the value to the accumulator.
-		this->acc += results.at(i);
+	/**Accumulate the totals of a series one sample at a time.
+	 * \param the samples
+	 * \param the number of samples
+	 * \param the shift to take differences from
+	 * \param [in,out] the totals to accumulate into
+	 */
+	void sum_scalar(const uint64_t* data,
+					size_t n,
+					uint64_t shift,
+					SeriesSums& sums)
+	{
+		for (size_t i = 0; i < n; ++i) {
+			const uint64_t x = data[i];
+			sums.sum += x;
+			sums.min = std::min(sums.min, x);
+			sums.max = std::max(sums.max, x);
+			const double d =
+				static_cast<double>(static_cast<int64_t>(x - shift));
+			sums.dev += d;
+			sums.dev_sq += d * d;
+		}
 	}
 
-	// Calculate mean.
-	this->mean = this->acc / repeat;
+#if GOLDILOCKS_HAS_X86_SIMD
+	/* The vector kernels convert samples to double by OR-ing them into
+	 * the mantissa of 2^52, which is only exact below 2^52 ticks (weeks,
+	 * even for the TSC). They OR every sample together to check this,
+	 * and report failure so that the caller can fall back to scalar. */
+
+	/// 2^52, as a double.
+	const double TWO_POW_52 = 4503599627370496.0;
+
+	/**Accumulate the totals of a series four samples at a time.
+	 * \param the samples
+	 * \param the number of samples
+	 * \param the shift to take differences from
+	 * \param [in,out] the totals to accumulate into
+	 * \return true if every sample was small enough to convert, else false
+	 */
+	__attribute__((target("avx2"))) bool sum_avx2(const uint64_t* data,
+												  size_t n,
+												  uint64_t shift,
+												  SeriesSums& sums)
+	{
+		const __m256d magic = _mm256_set1_pd(TWO_POW_52);
+		const __m256i magic_bits = _mm256_castpd_si256(magic);
+		const __m256d shift_d = _mm256_set1_pd(static_cast<double>(shift));
+
+		// Two sets of accumulators, to keep both adders busy.
+		__m256i sum0 = _mm256_setzero_si256(), sum1 = _mm256_setzero_si256();
+		__m256i bits = _mm256_setzero_si256();
+		__m256d lo0 = _mm256_set1_pd(TWO_POW_52), lo1 = lo0;
+		__m256d hi0 = _mm256_set1_pd(-1.0), hi1 = hi0;
+		__m256d dev0 = _mm256_setzero_pd(), dev1 = dev0;
+		__m256d sq0 = _mm256_setzero_pd(), sq1 = sq0;
+
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			__m256i x0 = _mm256_loadu_si256((const __m256i*)(data + i));
+			__m256i x1 = _mm256_loadu_si256((const __m256i*)(data + i + 4));
+			sum0 = _mm256_add_epi64(sum0, x0);
+			sum1 = _mm256_add_epi64(sum1, x1);
+			bits = _mm256_or_si256(bits, _mm256_or_si256(x0, x1));
+
+			__m256d d0 = _mm256_sub_pd(
+				_mm256_castsi256_pd(_mm256_or_si256(x0, magic_bits)), magic);
+			__m256d d1 = _mm256_sub_pd(
+				_mm256_castsi256_pd(_mm256_or_si256(x1, magic_bits)), magic);
+			lo0 = _mm256_min_pd(lo0, d0);
+			lo1 = _mm256_min_pd(lo1, d1);
+			hi0 = _mm256_max_pd(hi0, d0);
+			hi1 = _mm256_max_pd(hi1, d1);
+
+			d0 = _mm256_sub_pd(d0, shift_d);
+			d1 = _mm256_sub_pd(d1, shift_d);
+			dev0 = _mm256_add_pd(dev0, d0);
+			dev1 = _mm256_add_pd(dev1, d1);
+			sq0 = _mm256_add_pd(sq0, _mm256_mul_pd(d0, d0));
+			sq1 = _mm256_add_pd(sq1, _mm256_mul_pd(d1, d1));
+		}
+
+		alignas(32) uint64_t sum_lanes[4], bit_lanes[4];
+		alignas(32) double lo_lanes[4], hi_lanes[4], dev_lanes[4], sq_lanes[4];
+		_mm256_store_si256((__m256i*)sum_lanes, _mm256_add_epi64(sum0, sum1));
+		_mm256_store_si256((__m256i*)bit_lanes, bits);
+		_mm256_store_pd(lo_lanes, _mm256_min_pd(lo0, lo1));
+		_mm256_store_pd(hi_lanes, _mm256_max_pd(hi0, hi1));
+		_mm256_store_pd(dev_lanes, _mm256_add_pd(dev0, dev1));
+		_mm256_store_pd(sq_lanes, _mm256_add_pd(sq0, sq1));
 
-	// Store the minimum and maximum values.
-	this->min_val = this->results.at(0);
-	this->max_val = this->results.at(results.size() - 1);
+		/* GCC doesn't always clear the upper halves itself in a function
+		 * targeted this way, and leaving them dirty makes every SSE
+		 * instruction after us (even in libm) pay for a transition.*/
+		_mm256_zeroupper();
 
-	// Calculate the range as the maximum - minimum values.
-	this->range = this->max_val - this->min_val;
+		uint64_t all_bits = 0;
+		for (int lane = 0; lane < 4; ++lane) {
+			all_bits |= bit_lanes[lane];
+			sums.sum += sum_lanes[lane];
+			sums.dev += dev_lanes[lane];
+			sums.dev_sq += sq_lanes[lane];
+			if (i > 0) {
+				sums.min = std::min(sums.min, (uint64_t)lo_lanes[lane]);
+				sums.max = std::max(sums.max, (uint64_t)hi_lanes[lane]);
+			}
+		}
+		sum_scalar(data + i, n - i, shift, sums);
+		return (all_bits >> 52) == 0 && (shift >> 52) == 0;
+	}
 
-	/* Calculate standard deviance (s) from variance (s^2).
-	 * This is calculated as s^2 = [ (arr[i] - mean)^2 / (count-1) ]
-	 * and s = √[s^2]
+	/**Accumulate the totals of a series two samples at a time.
+	 * \param the samples
+	 * \param the number of samples
+	 * \param the shift to take differences from
+	 * \param [in,out] the totals to accumulate into
+	 * \return true if every sample was small enough to convert, else false
 	 */
-	// We'll be using this accumulator temporarily.
-	int64_t v_acc = 0;
-	// A temporary integer.
-	// cppcheck-suppress unreadVariable
-	int64_t temp = 0;
-	// We'll loop to create the summation. For each value...
-	for (uint64_t i = 0; i < repeat; i++) {
-		// Add (arr[i] - mean)^2 to the accumulator.
-		temp = results[i] - this->mean;
-		v_acc += (temp * temp);
-	}
-
-	// The variance is the accumulator / the count minus one.
-	double variance = v_acc / (repeat - 1);
-	// The standard deviation is the square root of the variance.
-	this->std_dev = sqrt(variance);
+	__attribute__((target("sse2"))) bool sum_sse2(const uint64_t* data,
+												  size_t n,
+												  uint64_t shift,
+												  SeriesSums& sums)
+	{
+		const __m128d magic = _mm_set1_pd(TWO_POW_52);
+		const __m128i magic_bits = _mm_castpd_si128(magic);
+		const __m128d shift_d = _mm_set1_pd(static_cast<double>(shift));
 
-	/* The relative standard deviation is the standard deviation / mean,
-	 * expressed as a percentage.*/
-	this->rsd = (this->std_dev / this->mean) * 100;
+		__m128i sum = _mm_setzero_si128();
+		__m128i bits = _mm_setzero_si128();
+		__m128d lo = _mm_set1_pd(TWO_POW_52);
+		__m128d hi = _mm_set1_pd(-1.0);
+		__m128d dev = _mm_setzero_pd();
+		__m128d sq = _mm_setzero_pd();
+
+		size_t i = 0;
+		for (; i + 2 <= n; i += 2) {
+			__m128i x = _mm_loadu_si128((const __m128i*)(data + i));
+			sum = _mm_add_epi64(sum, x);
+			bits = _mm_or_si128(bits, x);
+
+			__m128d d = _mm_sub_pd(
+				_mm_castsi128_pd(_mm_or_si128(x, magic_bits)), magic);
+			lo = _mm_min_pd(lo, d);
+			hi = _mm_max_pd(hi, d);
+
+			d = _mm_sub_pd(d, shift_d);
+			dev = _mm_add_pd(dev, d);
+			sq = _mm_add_pd(sq, _mm_mul_pd(d, d));
+		}
 
-	// Calculate median.
-	int mI = repeat / 2;
-	// If we have a single value as our exact median...
-	if (repeat % 2 == 0) {
-		// Store that value as the median.
-		this->median = results[mI];
+		alignas(16) uint64_t sum_lanes[2], bit_lanes[2];
+		alignas(16) double lo_lanes[2], hi_lanes[2], dev_lanes[2], sq_lanes[2];
+		_mm_store_si128((__m128i*)sum_lanes, sum);
+		_mm_store_si128((__m128i*)bit_lanes, bits);
+		_mm_store_pd(lo_lanes, lo);
+		_mm_store_pd(hi_lanes, hi);
+		_mm_store_pd(dev_lanes, dev);
+		_mm_store_pd(sq_lanes, sq);
+
+		uint64_t all_bits = 0;
+		for (int lane = 0; lane < 2; ++lane) {
+			all_bits |= bit_lanes[lane];
+			sums.sum += sum_lanes[lane];
+			sums.dev += dev_lanes[lane];
+			sums.dev_sq += sq_lanes[lane];
+			if (i > 0) {
+				sums.min = std::min(sums.min, (uint64_t)lo_lanes[lane]);
+				sums.max = std::max(sums.max, (uint64_t)hi_lanes[lane]);
+			}
+		}
+		sum_scalar(data + i, n - i, shift, sums);
+		return (all_bits >> 52) == 0 && (shift >> 52) == 0;
 	}
-	// Otherwise, if we do NOT have a single value as our exact median...
-	else {
-		// Store the mean of the middle two values as the median.
-		this->median = ((results[mI] + results[mI + 1]) / 2);
+#endif
+
+	/**Take the sum, minimum, maximum and (shifted) sum of squares of a
+	 * series in a single pass, with the widest vector unit available.
+	 * \param the samples
+	 * \param the number of samples
+	 * \param the shift to take differences from
+	 * \return the totals of the series
+	 */
+	SeriesSums sum_series(const uint64_t* data, size_t n, uint64_t shift)
+	{
+		SeriesSums sums;
+#if GOLDILOCKS_HAS_X86_SIMD
+		static const bool has_avx2 = __builtin_cpu_supports("avx2");
+		static const bool has_sse2 = __builtin_cpu_supports("sse2");
+		if (has_avx2) {
+			if (sum_avx2(data, n, shift, sums)) {
+				return sums;
+			}
+			sums = SeriesSums();
+		} else if (has_sse2) {
+			if (sum_sse2(data, n, shift, sums)) {
+				return sums;
+			}
+			sums = SeriesSums();
+		}
+#endif
+		sum_scalar(data, n, shift, sums);
+		return sums;
 	}
 
-	// Calculate lower and upper quartile values.
-	int q1I = repeat / 4;
-	int q3I = repeat * 3 / 4;
+	/**Find a quantile of a series by interpolating between the two
+	 * nearest order statistics, selecting them without a full sort.
+	 * The range searched must already hold every sample of those ranks,
+	 * which is true of any range bounded by previously selected ranks.
+	 * \param the series
+	 * \param the quantile, in [0, 1]
+	 * \param the first index of the range to search
+	 * \param the end of the range to search
+	 * \param [out] the lower rank used, which bounds later searches
+	 * \return the value of the quantile
+	 */
+	double select_quantile(samples_t& samples,
+						   double p,
+						   size_t first,
+						   size_t last,
+						   size_t& rank)
+	{
+		uint64_t* data = samples.data();
+		const double h = p * (samples.size() - 1);
+		rank = static_cast<size_t>(floor(h));
+		std::nth_element(data + first, data + rank, data + last);
 
-	// We're following the same basic approach as with median.
-	if (repeat % 4 == 0) {
-		this->q1 = results[q1I];
-		this->q3 = results[q3I];
-	} else {
-		this->q1 = (results[q1I] + results[q1I + 1]) / 2;
-		this->q3 = (results[q3I] + results[q3I + 1]) / 2;
-	}
-
-	// Calculate the interquartile value (transitory).
-	uint64_t iq = this->q3 - this->q1;
-
-	// Calculate the lower and upper inner and outer fence.
-	this->lif = this->q1 - (iq * 1.5);
-	this->uif = this->q3 + (iq * 1.5);
-	this->lof = this->q1 - (iq * 3);
-	this->uof = this->q3 + (iq * 3);
-
-	/* Calculate the number of minor and major LOWER outliers.*/
-
-	/* These will correspond to the index just past the last outlier
-	 * in each direction, for use in calculating the adjusted values,
-	 * which omit outliers.*/
-	int lower_cutoff = 0;
-	int upper_cutoff = repeat - 1;
-
-	// For each item (ascending)
-	for (uint64_t i = 0; i < repeat; i++) {
-		// If the item is smaller than the inner fence value...
-		if (results[i] < this->lif) {
-			// If the item is also smaller than the outer fence value...
-			if (results[i] < this->lof) {
-				// It is a major outlier.
-				this->low_out_major++;
-			}
-			// Otherwise...
-			else {
-				// It is a minor outlier.
-				this->low_out_minor++;
+		double value = data[rank];
+		const double frac = h - rank;
+		if (frac > 0) {
+			/* Everything after the selected rank is no smaller, so the next
+			 * order statistic is the smallest of them. */
+			uint64_t* end = (rank + 1 < last) ? data + last
+											  : data + samples.size();
+			value += frac * (*std::min_element(data + rank + 1, end) - value);
+		}
+		return value;
+	}
+
+	/**Find a percentile of a series by the nearest-rank method, selecting
+	 * it without a full sort. The range from first to the end must hold
+	 * every sample of that rank.
+	 * \param the series
+	 * \param the percentile, from 0 to 100
+	 * \param the first index of the range to search
+	 * \param [out] the rank used, which bounds later searches
+	 * \return the value at that percentile
+	 */
+	uint64_t select_rank(samples_t& samples,
+						 double percent,
+						 size_t first,
+						 size_t& rank)
+	{
+		rank = static_cast<size_t>(ceil(percent / 100 * samples.size()));
+		rank = std::max(rank, first + 1) - 1;
+		std::nth_element(
+			samples.begin() + first, samples.begin() + rank, samples.end());
+		return samples[rank];
+	}
+
+	/** Scales a median absolute deviation to estimate the standard
+	 * deviation, were the data normal.*/
+	const double MAD_SCALE = 1.4826;
+
+	/** The fences beyond which samples are outliers. Fences that are
+	 * infinitely far out never catch anything.*/
+	struct Fences {
+		/// The lower outer fence.
+		double lof = -INFINITY;
+
+		/// The lower inner fence.
+		double lif = -INFINITY;
+
+		/// The upper inner fence.
+		double uif = INFINITY;
+
+		/// The upper outer fence.
+		double uof = INFINITY;
+	};
+
+	/**Build fences some distance beyond either end of a range, with the
+	 * outer fences twice as far out as the inner ones.
+	 * \param the bottom of the range
+	 * \param the top of the range
+	 * \param the distance out to the inner fences
+	 * \return the fences
+	 */
+	Fences fences_around(double low, double high, double spread)
+	{
+		Fences fences;
+		fences.lif = low - spread;
+		fences.uif = high + spread;
+		fences.lof = low - spread * 2;
+		fences.uof = high + spread * 2;
+		return fences;
+	}
+
+	/**Find how many samples to trim off each end of a series.
+	 * \param the size of the series
+	 * \param the percentage to trim off each end
+	 * \return the number to trim off each end, leaving at least one
+	 */
+	size_t trim_count(size_t n, double percent)
+	{
+		const double cut = floor(std::max(percent, 0.0) / 100 * n);
+		return std::min(static_cast<size_t>(cut), (n - 1) / 2);
+	}
+
+	/**Convert a fence into whole ticks, clamping it to the range of a tick
+	 * count.
+	 * \param the fence
+	 * \return the fence in whole ticks
+	 */
+	uint64_t fence_ticks(double fence)
+	{
+		if (!(fence > 0)) {
+			return 0;
+		}
+		if (fence >= static_cast<double>(UINT64_MAX)) {
+			return UINT64_MAX;
+		}
+		return static_cast<uint64_t>(fence + 0.5);
+	}
+
+	/**Store fences, and the ranks of the samples they retain, in the
+	 * statistics of a series whose outliers have been counted.
+	 * \param the fences
+	 * \param [in,out] the statistics of the series
+	 */
+	void store_fences(const Fences& fences, SeriesStats& stats)
+	{
+		stats.lof = fence_ticks(fences.lof);
+		stats.lif = fence_ticks(fences.lif);
+		stats.uif = fence_ticks(fences.uif);
+		stats.uof = fence_ticks(fences.uof);
+		stats.retained_first = stats.low_out_minor + stats.low_out_major;
+		stats.retained_last =
+			stats.repeat - 1 - stats.upp_out_minor - stats.upp_out_major;
+	}
+
+	/**Find the median absolute deviation of a series from its median.
+	 * \param the series
+	 * \param the median of the series
+	 * \return the median absolute deviation
+	 */
+	double series_mad(const samples_t& samples, double median)
+	{
+		std::vector<double> deviations(samples.size());
+		for (size_t i = 0; i < samples.size(); ++i) {
+			deviations[i] = fabs(samples[i] - median);
+		}
+		const size_t mid = deviations.size() / 2;
+		std::nth_element(
+			deviations.begin(), deviations.begin() + mid, deviations.end());
+		double mad = deviations[mid];
+		if (deviations.size() % 2 == 0) {
+			// The other middle deviation is the largest below this one.
+			mad = (mad + *std::max_element(deviations.begin(),
+										   deviations.begin() + mid)) /
+				  2;
+		}
+		return mad;
+	}
+
+	/**Find the median absolute deviation of a histogram from its median,
+	 * to the histogram's precision, by searching for the narrowest band
+	 * around the median that holds half the samples.
+	 * \param the histogram
+	 * \param the median of the histogram
+	 * \return the median absolute deviation
+	 */
+	uint64_t histogram_mad(const HdrHistogram& histogram, uint64_t median)
+	{
+		const uint64_t half = (histogram.size() + 1) / 2;
+		uint64_t low = 0;
+		uint64_t high = std::max(median - histogram.min(),
+								 histogram.max() - median);
+		while (low < high) {
+			const uint64_t mid = low + (high - low) / 2;
+			const uint64_t bottom = (median > mid) ? median - mid : 0;
+			if (histogram.count_between(bottom, median + mid) >= half) {
+				high = mid;
+			} else {
+				low = mid + 1;
 			}
-		} else {
-			/* We've found the first non-outlier value.
-			 * Store the index as lower cutoff.*/
-			lower_cutoff = i;
-			// We're done. No sense counting further in a sorted array.
+		}
+		return low;
+	}
+}  // namespace
+
+void BenchmarkResult::finalize()
+{
+	if (this->storage != SampleStorage::raw) {
+		// The paired differences were calculated as the samples came in.
+		this->diff_mean = this->stream_diff.mean();
+		this->diff_std_dev = this->stream_diff.std_dev();
+	}
+
+	if (this->storage == SampleStorage::streaming) {
+		this->finalize_stream(this->stream_a, this->stats_a);
+		this->finalize_stream(this->stream_b, this->stats_b);
+	} else if (this->storage == SampleStorage::histogram) {
+		this->finalize_histogram(
+			*this->hist_a, this->stats_a, this->outlier_policy);
+		this->finalize_histogram(
+			*this->hist_b, this->stats_b, this->outlier_policy);
+	} else {
+		/* Calculate the paired statistics first: finalizing each series
+		 * reorders it, which breaks up the pairs.*/
+		this->finalize_pairs();
+
+		this->finalize_series(
+			this->samples_a, this->stats_a, this->outlier_policy);
+		this->finalize_series(
+			this->samples_b, this->stats_b, this->outlier_policy);
+	}
+
+	/* If either side's mean measurement is no larger than the jitter of
+	 * the clock overhead, we're measuring the clock more than the test.
+	 * The clock was read around a whole batch, so compare the batch, not
+	 * the single run the samples were scaled down to.*/
+	const double noise = static_cast<double>(this->overhead.noise_floor);
+	this->below_noise_floor =
+		(static_cast<double>(this->stats_a.mean) * this->batch_test <=
+		 noise) ||
+		(static_cast<double>(this->stats_b.mean) * this->batch_comparative <=
+		 noise);
+
+	this->compare();
+
+	// Resampling needs every sample, which only raw storage keeps.
+	this->bootstrap = BootstrapResult();
+	if (this->storage == SampleStorage::raw && this->size() > 1) {
+		this->bootstrap = bootstrap_intervals(this->samples_a.data(),
+											  this->samples_a.size(),
+											  this->samples_b.data(),
+											  this->samples_b.size(),
+											  this->bootstrap_resamples,
+											  1 - this->alpha,
+											  this->bootstrap_threads,
+											  this->bootstrap_seed);
+	}
+
+	if (this->size() == 0) {
+		this->verdict = BenchmarkVerdict::none;
+		return;
+	}
+
+	/* Without instruction counts (on both sides, and in the same pairs),
+	 * time is all there is to judge.*/
+	const size_t instructions = static_cast<size_t>(Counter::instructions);
+	this->metric = this->metric_requested;
+	if ((this->counters & counter_bit(Counter::instructions)) == 0 ||
+		this->counts_a[instructions].size() == 0 ||
+		this->counts_b[instructions].size() == 0 ||
+		this->instruction_diff.size() == 0) {
+		this->metric = Metric::time;
+	}
+	if (this->metric == Metric::instructions) {
+		this->judge_instructions();
+		return;
+	}
+
+	// A single measurement (or a noisy one) can't be trusted either way.
+	if (this->size() < 2 || this->below_noise_floor ||
+		this->stats_a.rsd_adj > this->max_rsd ||
+		this->stats_b.rsd_adj > this->max_rsd) {
+		this->verdict = BenchmarkVerdict::questionable;
+	} else if (this->comparison.p >= this->alpha) {
+		// The difference is indistinguishable from noise.
+		this->verdict = BenchmarkVerdict::draw;
+	} else if (this->comparison.estimate < 0) {
+		// The test was faster.
+		this->verdict = BenchmarkVerdict::win;
+	} else {
+		this->verdict = BenchmarkVerdict::loss;
+	}
+}
+
+void BenchmarkResult::compare()
+{
+	const VerdictMethod method =
+		(this->method == VerdictMethod::mann_whitney &&
+		 this->storage != SampleStorage::raw)
+			? VerdictMethod::welch_t
+			: this->method;
+
+	switch (method) {
+		case VerdictMethod::mann_whitney:
+			// The series are already out of order, so sorting costs nothing.
+			this->comparison = mann_whitney_u_test(this->samples_a.data(),
+												   this->samples_a.size(),
+												   this->samples_b.data(),
+												   this->samples_b.size(),
+												   this->alpha);
+			break;
+		case VerdictMethod::welch_t: {
+			const SeriesStats& a = this->stats_a;
+			const SeriesStats& b = this->stats_b;
+			// Use the exact means, rather than the whole ticks we store.
+			const double mean_a = (a.repeat > 0) ? (double)a.acc / a.repeat : 0;
+			const double mean_b = (b.repeat > 0) ? (double)b.acc / b.repeat : 0;
+			this->comparison = welch_t_test(mean_a,
+											a.std_dev,
+											a.repeat,
+											mean_b,
+											b.std_dev,
+											b.repeat,
+											this->alpha);
 			break;
 		}
+		default:
+			this->comparison = paired_t_test(
+				this->diff_mean, this->diff_std_dev, this->size(), this->alpha);
+			break;
 	}
+}
 
-	// For each item (descending)
-	for (uint64_t i = (repeat - 1); i != 0; i--) {
-		// If the item is larger than the inner fence value...
-		if (results[i] > this->uif) {
-			// If the item is also larger than the outer fence value...
-			if (results[i] > this->uof) {
-				// It is a major outlier.
-				this->upp_out_major++;
-			}
-			// Otherwise...
-			else {
-				// It is a minor outlier.
-				this->upp_out_minor++;
-			}
-		} else {
-			/* We've found the first non-outlier value.
-			 * Store the index as upper cutoff.*/
-			upper_cutoff = i;
-			// We're done. No sense counting further in a sorted array.
+void BenchmarkResult::judge_instructions()
+{
+	const size_t instructions = static_cast<size_t>(Counter::instructions);
+	const StreamingStats& a = this->counts_a[instructions];
+	const StreamingStats& b = this->counts_b[instructions];
+	if (this->method == VerdictMethod::paired_t) {
+		this->instruction_comparison =
+			paired_t_test(this->instruction_diff.mean(),
+						  this->instruction_diff.std_dev(),
+						  this->instruction_diff.size(),
+						  this->alpha);
+	} else {
+		this->instruction_comparison = welch_t_test(a.mean(),
+													a.std_dev(),
+													a.size(),
+													b.mean(),
+													b.std_dev(),
+													b.size(),
+													this->alpha);
+	}
+
+	auto rsd = [](const StreamingStats& stats) -> double {
+		return (stats.mean() > 0) ? stats.std_dev() / stats.mean() * 100 : 0;
+	};
+	const HypothesisTest& test = this->instruction_comparison;
+	if (a.size() < 2 || rsd(a) > this->max_rsd || rsd(b) > this->max_rsd) {
+		this->verdict = BenchmarkVerdict::questionable;
+	} else if (test.p >= this->alpha ||
+			   fabs(test.estimate) <= this->instruction_tolerance * b.mean()) {
+		/* Counts this steady make the slightest difference significant,
+		 * so a difference within the tolerance is a draw regardless.*/
+		this->verdict = BenchmarkVerdict::draw;
+	} else if (test.estimate < 0) {
+		// The test retired fewer instructions.
+		this->verdict = BenchmarkVerdict::win;
+	} else {
+		this->verdict = BenchmarkVerdict::loss;
+	}
+}
+
+void BenchmarkResult::finalize_pairs()
+{
+	/* Calculate the paired difference statistics. Because both halves of
+	 * a pair share whatever the machine was doing at the time, their
+	 * difference is far less noisy than either measurement alone.*/
+	const uint64_t pairs = samples_a.size();
+
+	/* Welford's method, which doesn't lose precision on large sums. Each
+	 * difference is used once, so it is never stored.*/
+	double mean_d = 0;
+	double m2 = 0;
+	for (uint64_t i = 0; i < pairs; i++) {
+		double difference = static_cast<double>(
+			static_cast<int64_t>(samples_a[i]) -
+			static_cast<int64_t>(samples_b[i]));
+		double delta = difference - mean_d;
+		mean_d += delta / (i + 1);
+		m2 += delta * (difference - mean_d);
+	}
+	this->diff_mean = mean_d;
+	this->diff_std_dev = (pairs > 1) ? sqrt(m2 / (pairs - 1)) : 0;
+}
+
+void BenchmarkResult::finalize_stream(const StreamingStats& stream,
+									  SeriesStats& stats)
+{
+	stats = SeriesStats();
+	if (stream.size() == 0) {
+		return;
+	}
+
+	// Measurements are whole ticks; round the running values to match.
+	auto ticks = [](double x) -> uint64_t { return (x > 0) ? llround(x) : 0; };
+
+	stats.repeat = stream.size();
+	stats.mean = ticks(stream.mean());
+	stats.acc = ticks(stream.mean() * stream.size());
+	stats.min_val = ticks(stream.min());
+	stats.max_val = ticks(stream.max());
+	stats.range = stats.max_val - stats.min_val;
+	stats.std_dev = stream.std_dev();
+	stats.rsd = (stream.mean() > 0) ? (stats.std_dev / stream.mean()) * 100 : 0;
+
+	stats.median = ticks(stream.median());
+	stats.q1 = ticks(stream.q1());
+	stats.q3 = ticks(stream.q3());
+	stats.p99 = ticks(stream.p99());
+	stats.p999 = ticks(stream.p999());
+	stats.p9999 = ticks(stream.p9999());
+
+	stats.low_out_minor = stream.low_minor();
+	stats.low_out_major = stream.low_major();
+	stats.upp_out_minor = stream.upper_minor();
+	stats.upp_out_major = stream.upper_major();
+
+	// Report the fences as they stand at the final quartile estimates.
+	const double fence_k = stream.get_fence_k();
+	stats.outliers = std::isfinite(fence_k) ? OutlierPolicy::tukey(fence_k)
+											: OutlierPolicy::none();
+	Fences fences;
+	if (std::isfinite(fence_k)) {
+		fences = fences_around(
+			stream.q1(), stream.q3(), (stream.q3() - stream.q1()) * fence_k);
+	}
+	store_fences(fences, stats);
+
+	stats.mean_adj = ticks(stream.mean_adj());
+	stats.acc_adj = ticks(stream.mean_adj() * stream.size_adj());
+	stats.min_adj_val = ticks(stream.min_adj());
+	stats.max_adj_val = ticks(stream.max_adj());
+	stats.range_adj = stats.max_adj_val - stats.min_adj_val;
+	stats.std_dev_adj = stream.std_dev_adj();
+	stats.rsd_adj = (stream.mean_adj() > 0)
+						? (stats.std_dev_adj / stream.mean_adj()) * 100
+						: 0;
+}
+
+void BenchmarkResult::finalize_histogram(const HdrHistogram& histogram,
+										 SeriesStats& stats,
+										 const OutlierPolicy& policy)
+{
+	stats = SeriesStats();
+	stats.outliers = policy;
+	if (histogram.size() == 0) {
+		return;
+	}
+
+	stats.repeat = histogram.size();
+	stats.min_val = histogram.min();
+	stats.max_val = histogram.max();
+	stats.range = stats.max_val - stats.min_val;
+
+	double mean = 0;
+	histogram.moments_between(0, UINT64_MAX, mean, stats.std_dev);
+	stats.mean = llround(mean);
+	stats.acc = llround(mean * stats.repeat);
+	stats.rsd = (mean > 0) ? (stats.std_dev / mean) * 100 : 0;
+
+	stats.median = histogram.percentile(50);
+	stats.q1 = histogram.percentile(25);
+	stats.q3 = histogram.percentile(75);
+	stats.p99 = histogram.percentile(99);
+	stats.p999 = histogram.percentile(99.9);
+	stats.p9999 = histogram.percentile(99.99);
+
+	Fences fences;
+	switch (policy.method) {
+		case OutlierMethod::tukey:
+			fences = fences_around(
+				stats.q1, stats.q3, (stats.q3 - stats.q1) * policy.k);
+			break;
+		case OutlierMethod::mad:
+			fences = fences_around(stats.median,
+								   stats.median,
+								   histogram_mad(histogram, stats.median) *
+									   MAD_SCALE * policy.k);
+			break;
+		case OutlierMethod::trim: {
+			const size_t cut = trim_count(stats.repeat, policy.k);
+			fences.lif = histogram.percentile(100.0 * (cut + 1) / stats.repeat);
+			fences.uif = histogram.percentile(
+				100.0 * (stats.repeat - cut) / stats.repeat);
 			break;
 		}
+		default:
+			break;
 	}
+	// Count outliers by the buckets beyond each fence.
+	auto below = [&](uint64_t fence) -> uint64_t {
+		return (fence > 0) ? histogram.count_between(0, fence - 1) : 0;
+	};
+	auto above = [&](uint64_t fence) -> uint64_t {
+		return (fence < UINT64_MAX)
+				   ? histogram.count_between(fence + 1, UINT64_MAX)
+				   : 0;
+	};
 
-	/* Calculate the adjusted accumulator.
-	 * For each item in the array, within cutoffs...*/
-	for (int i = lower_cutoff; i <= upper_cutoff; i++) {
-		// Add the value to the accumulator.
-		this->acc_adj += results[i];
+	// If nothing is left between the fences, keep every sample instead.
+	if (below(fence_ticks(fences.lif)) + above(fence_ticks(fences.uif)) >=
+		stats.repeat) {
+		stats.outliers = OutlierPolicy::none();
+		fences = Fences();
 	}
+	stats.lof = fence_ticks(fences.lof);
+	stats.lif = fence_ticks(fences.lif);
+	stats.uif = fence_ticks(fences.uif);
+	stats.uof = fence_ticks(fences.uof);
 
-	// Calculate a new count to work with, omitting outliers.
-	int repeat_adj = upper_cutoff - lower_cutoff;
+	const uint64_t below_lif = below(stats.lif);
+	const uint64_t above_uif = above(stats.uif);
+	stats.low_out_major = below(stats.lof);
+	stats.low_out_minor = below_lif - stats.low_out_major;
+	stats.upp_out_major = above(stats.uof);
+	stats.upp_out_minor = above_uif - stats.upp_out_major;
+	store_fences(fences, stats);
 
-	// Calculate adjusted mean.
-	this->mean_adj = this->acc_adj / repeat_adj;
+	// The adjusted statistics are those of the buckets within the fences.
+	double mean_adj = 0;
+	uint64_t repeat_adj = histogram.moments_between(
+		stats.lif, stats.uif, mean_adj, stats.std_dev_adj);
+	stats.mean_adj = llround(mean_adj);
+	stats.acc_adj = llround(mean_adj * repeat_adj);
+	stats.rsd_adj =
+		(mean_adj > 0) ? (stats.std_dev_adj / mean_adj) * 100 : 0;
 
-	// Store the minimum and maximum non-outlier values.
-	this->min_adj_val = results[lower_cutoff];
-	this->max_adj_val = results[upper_cutoff];
+	// The first and last samples (by rank) that aren't outliers.
+	stats.min_adj_val = histogram.percentile(
+		100.0 * (below_lif + 1) / stats.repeat);
+	stats.max_adj_val = histogram.percentile(
+		100.0 * (stats.repeat - above_uif) / stats.repeat);
+	stats.range_adj = stats.max_adj_val - stats.min_adj_val;
 
-	// Calculate the adjusted range as the maximum - minimum (adjusted) values.
-	this->range_adj = this->max_adj_val - this->min_adj_val;
+	stats.modality = analyze_modality(histogram);
+}
 
-	/* Calculate adjusted standard deviance (s) from variance (s^2).
-	 * This is calculated as s^2 = [ (arr[i] - mean)^2 / (count-1) ]
-	 * and s = √[s^2], except using the adjusted numbers.
-	 */
-	// We'll be reusing this accumulator from earlier.
-	v_acc = 0;
-	// We'll loop to create the summation. For each value...
-	for (int i = 0; i < repeat_adj; i++) {
-		temp = results[i] - this->mean_adj;
-		// Add (arr[i] - mean)^2 to the accumulator.
-		v_acc += (temp * temp);
-	}
-	// The variance is the accumulator / the count minus one.
-	double variance_adj = v_acc / (repeat_adj - 1);
-	// The standard deviation is the square root of the variance.
-	this->std_dev_adj = sqrt(variance_adj);
+void BenchmarkResult::finalize_series(samples_t& samples,
+									  SeriesStats& stats,
+									  const OutlierPolicy& policy)
+{
+	// Start from a clean slate, in case we're finalizing again.
+	stats = SeriesStats();
+	stats.outliers = policy;
+
+	// An empty series has no statistics.
+	if (samples.empty()) {
+		return;
+	}
+
+	const size_t n = samples.size();
+	stats.repeat = n;
+
+	/* Take the accumulator, extremes and variance in one pass. The first
+	 * sample is as good a shift as any, until we know the median.*/
+	SeriesSums sums = sum_series(samples.data(), n, samples[0]);
+	stats.acc = sums.sum;
+	stats.mean = stats.acc / n;
+	stats.min_val = sums.min;
+	stats.max_val = sums.max;
+	stats.range = stats.max_val - stats.min_val;
+
+	/* The variance is [ sum((x - k)^2) - sum(x - k)^2 / n ] / (n - 1)
+	 * for any shift k, and the standard deviation is its square root.*/
+	if (n > 1) {
+		double variance = (sums.dev_sq - sums.dev * sums.dev / n) / (n - 1);
+		stats.std_dev = sqrt(std::max(variance, 0.0));
+	}
 
 	/* The relative standard deviation is the standard deviation / mean,
 	 * expressed as a percentage.*/
-	this->rsd_adj = (this->std_dev_adj / this->mean_adj) * 100;
+	if (stats.mean > 0) {
+		stats.rsd = (stats.std_dev / stats.mean) * 100;
+	}
 
-	// Calculate difference between the adjusted mean averages.
-	this->verdict = BenchmarkVerdict::none;
-	int64_t difference_adj = result1.mean_adj - result2.mean_adj;
+	/* Select the median, then each quartile within its half, then each
+	 * tail percentile above the last. Every selection only partitions
+	 * what's left, so this costs far less than sorting.*/
+	size_t median_rank, q1_rank, q3_rank, tail_rank;
+	const double median = select_quantile(samples, 0.5, 0, n, median_rank);
+	const double q1 =
+		select_quantile(samples, 0.25, 0, median_rank + 1, q1_rank);
+	const double q3 = select_quantile(samples, 0.75, median_rank, n, q3_rank);
+	stats.median = llround(median);
+	stats.q1 = llround(q1);
+	stats.q3 = llround(q3);
 
-	if (labs(difference_adj) <= result1.std_dev_adj ||
-		labs(difference_adj) <= result2.std_dev_adj) {
-		// The tests are roughly the same.
-		this->verdict = BenchmarkVerdict::draw;
-	} else {
-		// If first test won
-		if (difference_adj < 0) {
-			this->verdict = BenchmarkVerdict::win;
-		} else if (difference_adj > 0) {
-			this->verdict = BenchmarkVerdict::loss;
-		} else if (difference_adj > std_dev_adj) {  // TODO RSD too high
-			this->verdict = BenchmarkVerdict::questionable;
+	stats.p99 = select_rank(samples, 99, q3_rank, tail_rank);
+	stats.p999 = select_rank(samples, 99.9, tail_rank, tail_rank);
+	stats.p9999 = select_rank(samples, 99.99, tail_rank, tail_rank);
+
+	// Calculate the lower and upper inner and outer fences.
+	Fences fences;
+	switch (policy.method) {
+		case OutlierMethod::tukey:
+			fences = fences_around(q1, q3, (q3 - q1) * policy.k);
+			break;
+		case OutlierMethod::mad:
+			fences = fences_around(median,
+								   median,
+								   series_mad(samples, median) * MAD_SCALE *
+									   policy.k);
+			break;
+		case OutlierMethod::trim: {
+			// Fence at the last trimmed ranks; ties with them are kept.
+			const size_t cut = trim_count(n, policy.k);
+			uint64_t* data = samples.data();
+			std::nth_element(data, data + cut, data + n);
+			fences.lif = data[cut];
+			std::nth_element(data + cut, data + n - 1 - cut, data + n);
+			fences.uif = data[n - 1 - cut];
+			break;
 		}
+		default:
+			break;
 	}
-}
\ No newline at end of file
+	const double lif = fences.lif;
+	const double uif = fences.uif;
+	const double lof = fences.lof;
+	const double uof = fences.uof;
+
+	/* Count the outliers and take the adjusted statistics (which omit
+	 * outliers) in one more pass, shifted by the median this time.*/
+	const uint64_t shift = stats.median;
+	uint64_t repeat_adj = 0;
+	SeriesSums adj;
+	for (size_t i = 0; i < n; ++i) {
+		const uint64_t x = samples[i];
+		const double xd = static_cast<double>(x);
+		if (xd < lif) {
+			if (xd < lof) {
+				stats.low_out_major++;
+			} else {
+				stats.low_out_minor++;
+			}
+		} else if (xd > uif) {
+			if (xd > uof) {
+				stats.upp_out_major++;
+			} else {
+				stats.upp_out_minor++;
+			}
+		} else {
+			++repeat_adj;
+			adj.sum += x;
+			adj.min = std::min(adj.min, x);
+			adj.max = std::max(adj.max, x);
+			const double d =
+				static_cast<double>(static_cast<int64_t>(x - shift));
+			adj.dev += d;
+			adj.dev_sq += d * d;
+		}
+	}
+
+	/* Fences narrower than the gap around an interpolated median can
+	 * leave nothing between them; keep every sample instead.*/
+	if (repeat_adj == 0) {
+		stats.outliers = OutlierPolicy::none();
+		stats.low_out_minor = 0;
+		stats.low_out_major = 0;
+		stats.upp_out_minor = 0;
+		stats.upp_out_major = 0;
+		fences = Fences();
+		repeat_adj = n;
+		adj = sums;
+	}
+
+	store_fences(fences, stats);
+
+	stats.acc_adj = adj.sum;
+	stats.mean_adj = stats.acc_adj / repeat_adj;
+	stats.min_adj_val = adj.min;
+	stats.max_adj_val = adj.max;
+	stats.range_adj = stats.max_adj_val - stats.min_adj_val;
+
+	if (repeat_adj > 1) {
+		double variance_adj =
+			(adj.dev_sq - adj.dev * adj.dev / repeat_adj) / (repeat_adj - 1);
+		stats.std_dev_adj = sqrt(std::max(variance_adj, 0.0));
+	}
+	if (stats.mean_adj > 0) {
+		stats.rsd_adj = (stats.std_dev_adj / stats.mean_adj) * 100;
+	}
+
+	stats.modality = analyze_modality(samples.data(),
+									  n,
+									  stats.min_val,
+									  stats.max_val,
+									  static_cast<double>(stats.acc) / n);
+}
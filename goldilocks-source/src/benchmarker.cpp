@@ -29,7 +29,8 @@ void Benchmarker::benchmark()
 
 	// Step 6: If there are still iterations of the test to be run,
 	// return to step 4.
-	for (uint16_t i = 0; i < this->iterations; ++i) {
+	for (BudgetTracker tracker(this->budget); !tracker.done();
+		 tracker.count()) {
 		// run janitor() from test. If fails, call postmortem()
 		if (!this->test->janitor()) {
 			this->test->postmortem();
@@ -0,0 +1,360 @@
+#include "goldilocks/bootstrap.hpp"
+
+#include <algorithm>  // std::sort, std::nth_element, std::min
+#include <atomic>     // std::atomic
+#include <cmath>      // ceil, exp, floor, sqrt
+#include <random>     // std::gamma_distribution
+#include <thread>     // std::thread
+#include <vector>     // std::vector
+
+namespace {
+	/// How many random bits pick each Poisson(1) weight.
+	const uint32_t WEIGHT_BITS = 12;
+
+	/// How many weights one random word provides.
+	const size_t WEIGHTS_PER_WORD = 64 / WEIGHT_BITS;
+
+	/// How many mean resamples share one pass over a series.
+	const size_t BLOCK = WEIGHTS_PER_WORD * 4;
+
+	/** How many standard deviations of the median's rank either side of
+	 * the middle to keep sorted. A resampled median lands further out
+	 * with a probability below 1e-20.*/
+	const double MEDIAN_REACH = 10;
+
+	/** A xoshiro256** generator: small, fast, and good enough for
+	 * resampling. Each task gets its own, so threads never share one.*/
+	class Xoshiro256
+	{
+	private:
+		uint64_t s[4];
+
+		static uint64_t rotl(uint64_t x, int k)
+		{
+			return (x << k) | (x >> (64 - k));
+		}
+
+	public:
+		typedef uint64_t result_type;
+
+		/* Ctor
+		 * \param seed Any value; it is spread over the state by splitmix64
+		 */
+		explicit Xoshiro256(uint64_t seed)
+		{
+			for (uint64_t& word : this->s) {
+				uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+				word = z ^ (z >> 31);
+			}
+		}
+
+		static constexpr uint64_t min() { return 0; }
+		static constexpr uint64_t max() { return UINT64_MAX; }
+
+		uint64_t operator()()
+		{
+			const uint64_t result = rotl(this->s[1] * 5, 7) * 9;
+			const uint64_t t = this->s[1] << 17;
+			this->s[2] ^= this->s[0];
+			this->s[3] ^= this->s[1];
+			this->s[1] ^= this->s[2];
+			this->s[0] ^= this->s[3];
+			this->s[2] ^= t;
+			this->s[3] = rotl(this->s[3], 45);
+			return result;
+		}
+	};
+
+	/**Get the table that turns random bits into a Poisson(1) weight.
+	 * The table is small enough to stay in L1 cache; quantizing the
+	 * distribution to 1/4096 keeps its variance within 0.2% of exact.
+	 * \return the table, indexed by the random bits
+	 */
+	const std::vector<uint8_t>& poisson_table()
+	{
+		static const std::vector<uint8_t> table = []() {
+			std::vector<uint8_t> weights(1 << WEIGHT_BITS);
+			double term = exp(-1.0);
+			double cdf = term;
+			uint8_t k = 0;
+			for (size_t u = 0; u < weights.size(); ++u) {
+				// Invert the CDF at the middle of each step.
+				while (cdf <= (u + 0.5) / weights.size()) {
+					++k;
+					term /= k;
+					cdf += term;
+				}
+				weights[u] = k;
+			}
+			return weights;
+		}();
+		return table;
+	}
+
+	/**Run tasks across a pool of threads, each taking the next task
+	 * until there are none left.
+	 * \param the number of tasks
+	 * \param the number of threads, or 0 for one per core
+	 * \param the function to run for each task index
+	 */
+	template<typename Fn>
+	void parallel_for(size_t tasks, uint32_t threads, Fn fn)
+	{
+		if (threads == 0) {
+			threads = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+		threads = static_cast<uint32_t>(std::min<size_t>(threads, tasks));
+		std::atomic<size_t> next(0);
+		auto worker = [&]() {
+			for (size_t task = next++; task < tasks; task = next++) {
+				fn(task);
+			}
+		};
+
+		// This thread works too, so start one fewer.
+		std::vector<std::thread> pool;
+		for (uint32_t i = 1; i < threads; ++i) {
+			pool.emplace_back(worker);
+		}
+		worker();
+		for (std::thread& thread : pool) {
+			thread.join();
+		}
+	}
+
+	/**Draw from a Beta distribution, as the ratio of two Gamma draws.
+	 * \param the random generator
+	 * \param alpha
+	 * \param beta
+	 * \return the draw
+	 */
+	double beta_draw(Xoshiro256& rng, double a, double b)
+	{
+		const double x = std::gamma_distribution<double>(a)(rng);
+		const double y = std::gamma_distribution<double>(b)(rng);
+		return x / (x + y);
+	}
+
+	/** The middle ranks of a series, sorted: the only ranks that the
+	 * median of a resample can land on, in practice.*/
+	class MedianWindow
+	{
+	private:
+		/// The ranks in the window, in order.
+		std::vector<uint64_t> sorted;
+
+		/// The rank of the first sample in the window.
+		size_t first = 0;
+
+		/// The size of the whole series.
+		size_t n = 0;
+
+	public:
+		/* Ctor
+		 * \param x The series, which is left as it is
+		 * \param n The size of the series
+		 */
+		MedianWindow(const uint64_t* x, size_t n) : sorted(x, x + n), n(n)
+		{
+			/* The rank of the median of a resample has a standard
+			 * deviation of about sqrt(n) / 2. Select only the ranks
+			 * within reach of the middle, and sort just those.*/
+			const size_t reach =
+				static_cast<size_t>(ceil(MEDIAN_REACH * sqrt(n) / 2)) + 1;
+			const size_t middle = n / 2;
+			this->first = (middle > reach) ? middle - reach : 0;
+			const size_t last = std::min(middle + reach + 1, n);
+
+			auto begin = this->sorted.begin();
+			std::nth_element(begin, begin + this->first, this->sorted.end());
+			if (last < n) {
+				std::nth_element(
+					begin + this->first, begin + last, this->sorted.end());
+			}
+			std::sort(begin + this->first, begin + last);
+			this->sorted.erase(begin + last, this->sorted.end());
+			this->sorted.erase(begin, begin + this->first);
+		}
+
+		/**Get the sample at a rank, which is clamped to the window.
+		 * \param the rank, from 0 to n - 1
+		 * \return the sample
+		 */
+		uint64_t at(size_t rank) const
+		{
+			rank = std::max(rank, this->first) - this->first;
+			return this->sorted[std::min(rank, this->sorted.size() - 1)];
+		}
+
+		/// \return the median of the series
+		double median() const
+		{
+			return (this->n % 2 == 1)
+					   ? this->at(this->n / 2)
+					   : (this->at(this->n / 2 - 1) + this->at(this->n / 2)) /
+							 2.0;
+		}
+
+		/// \return the size of the series
+		size_t size() const { return this->n; }
+	};
+
+	/**Draw the median of a bootstrap resample of a series, without
+	 * building the resample.
+	 * \param the middle ranks of the series
+	 * \param the random generator
+	 * \return the median of the resample
+	 */
+	double resample_median(const MedianWindow& window, Xoshiro256& rng)
+	{
+		const size_t n = window.size();
+
+		// A uniform u picks the sample at rank ceil(n * u).
+		auto at = [&](double u) -> double {
+			return window.at(std::min(static_cast<size_t>(u * n), n - 1));
+		};
+
+		// The k-th smallest of n uniforms is Beta(k, n + 1 - k).
+		const size_t k = (n + 1) / 2;
+		const double u = beta_draw(rng, k, n + 1 - k);
+		if (n % 2 == 1) {
+			return at(u);
+		}
+		// The next smallest is the smallest of the n - k above it.
+		const double next = u + (1 - u) * beta_draw(rng, 1, n - k);
+		return (at(u) + at(next)) / 2;
+	}
+
+	/**Take a block of Poisson bootstrap means of a series in one pass.
+	 * \param the series
+	 * \param the size of the series
+	 * \param the random generator
+	 * \param [out] BLOCK resampled means
+	 */
+	void resample_means(const uint64_t* x,
+						size_t n,
+						Xoshiro256& rng,
+						double* means)
+	{
+		const uint8_t* table = poisson_table().data();
+		const uint64_t mask = (1u << WEIGHT_BITS) - 1;
+		double sums[BLOCK] = {};
+		uint64_t weights[BLOCK] = {};
+		for (size_t i = 0; i < n; ++i) {
+			const double value = static_cast<double>(x[i]);
+			// Each random word weights this sample in several resamples.
+			for (size_t r = 0; r < BLOCK; r += WEIGHTS_PER_WORD) {
+				const uint64_t bits = rng();
+				for (size_t j = 0; j < WEIGHTS_PER_WORD; ++j) {
+					const uint32_t w =
+						table[(bits >> (WEIGHT_BITS * j)) & mask];
+					sums[r + j] += w * value;
+					weights[r + j] += w;
+				}
+			}
+		}
+		for (size_t r = 0; r < BLOCK; ++r) {
+			// Every weight can be zero, if only for very short series.
+			means[r] = (weights[r] > 0) ? sums[r] / weights[r] : x[0];
+		}
+	}
+
+	/**Find a quantile of a sorted series, interpolating between ranks.
+	 * \param the sorted series
+	 * \param the quantile, in [0, 1]
+	 * \return the value of the quantile
+	 */
+	double quantile(const std::vector<double>& sorted, double p)
+	{
+		const double h = p * (sorted.size() - 1);
+		const size_t lo = static_cast<size_t>(floor(h));
+		const size_t hi = std::min(lo + 1, sorted.size() - 1);
+		return sorted[lo] + (h - lo) * (sorted[hi] - sorted[lo]);
+	}
+
+	/**Turn a set of resampled statistics into a percentile interval.
+	 * \param the resampled statistics, which are sorted in place
+	 * \param the statistic on the original samples
+	 * \param the confidence level
+	 * \return the interval
+	 */
+	BootstrapInterval interval(std::vector<double>& resampled,
+							   double estimate,
+							   double confidence)
+	{
+		std::sort(resampled.begin(), resampled.end());
+		BootstrapInterval result;
+		result.estimate = estimate;
+		result.low = quantile(resampled, (1 - confidence) / 2);
+		result.high = quantile(resampled, (1 + confidence) / 2);
+		return result;
+	}
+
+	/**Find the mean of a series.
+	 * \param the series
+	 * \param the size of the series
+	 * \return the mean
+	 */
+	double mean_of(const uint64_t* x, size_t n)
+	{
+		double mean = 0;
+		for (size_t i = 0; i < n; ++i) {
+			mean += (x[i] - mean) / (i + 1);
+		}
+		return mean;
+	}
+}  // namespace
+
+BootstrapResult bootstrap_intervals(const uint64_t* a,
+									size_t n_a,
+									const uint64_t* b,
+									size_t n_b,
+									uint32_t resamples,
+									double confidence,
+									uint32_t threads,
+									uint64_t seed)
+{
+	BootstrapResult result;
+	if (n_a == 0 || n_b == 0 || resamples == 0) {
+		return result;
+	}
+	result.resamples = resamples;
+	result.confidence = confidence;
+
+	const MedianWindow window_a(a, n_a);
+	const MedianWindow window_b(b, n_b);
+
+	// Round up to whole blocks; the extra resamples are simply unused.
+	const size_t tasks = (resamples + BLOCK - 1) / BLOCK;
+	std::vector<double> means_a(tasks * BLOCK), means_b(tasks * BLOCK);
+	std::vector<double> medians_a(resamples), medians_b(resamples);
+	std::vector<double> ratios(resamples);
+
+	parallel_for(tasks, threads, [&](size_t task) {
+		// Seed by task, not thread, so the result doesn't depend on timing.
+		Xoshiro256 rng(seed ^ (task * 0xD1B54A32D192ED03ULL));
+		resample_means(a, n_a, rng, &means_a[task * BLOCK]);
+		resample_means(b, n_b, rng, &means_b[task * BLOCK]);
+
+		const size_t end = std::min((task + 1) * BLOCK, (size_t)resamples);
+		for (size_t r = task * BLOCK; r < end; ++r) {
+			medians_a[r] = resample_median(window_a, rng);
+			medians_b[r] = resample_median(window_b, rng);
+			ratios[r] = (medians_b[r] > 0) ? medians_a[r] / medians_b[r] : 0;
+		}
+	});
+	means_a.resize(resamples);
+	means_b.resize(resamples);
+
+	const double median_a = window_a.median();
+	const double median_b = window_b.median();
+	result.mean_a = interval(means_a, mean_of(a, n_a), confidence);
+	result.mean_b = interval(means_b, mean_of(b, n_b), confidence);
+	result.median_a = interval(medians_a, median_a, confidence);
+	result.median_b = interval(medians_b, median_b, confidence);
+	result.median_ratio = interval(
+		ratios, (median_b > 0) ? median_a / median_b : 0, confidence);
+	return result;
+}
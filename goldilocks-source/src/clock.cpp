@@ -0,0 +1,383 @@
+#include "goldilocks/clock.hpp"
+
+#include <algorithm>  // std::sort
+#include <fstream>    // std::ifstream
+#include <string>     // std::string
+
+#if GOLDILOCKS_HAS_TSC
+#include <cpuid.h>
+#endif
+
+namespace {
+	/// How many timestamp pairs to take when probing a clock source.
+	const uint32_t PROBE_SAMPLES = 1000;
+
+	/// How many rounds of probing to take the best of.
+	const uint32_t PROBE_ROUNDS = 5;
+
+	/** How much of the current choice's overhead another source must
+	 * come in under to replace it, when picking automatically.*/
+	const double SWITCH_MARGIN = 0.75;
+
+	/// How long each timed TSC calibration window lasts, in nanoseconds.
+	const uint64_t CALIBRATION_WINDOW_NS = 10000000;
+
+	/// How many timed TSC calibration windows to take the median of.
+	const uint32_t CALIBRATION_ROUNDS = 3;
+
+	/// What we know about the TSC on this host.
+	struct TscTraits {
+		bool constant = false;
+		bool invariant = false;
+	};
+
+	/**Check whether the kernel reports a CPU flag in /proc/cpuinfo.
+	 * This catches constant-rate TSCs that CPUID can't tell us about.
+	 * \param the flag name to look for
+	 * \return true if the flag is present, else false
+	 */
+	bool cpuinfo_has_flag(const std::string& flag)
+	{
+		std::ifstream cpuinfo("/proc/cpuinfo");
+		std::string line;
+		while (std::getline(cpuinfo, line)) {
+			if (line.compare(0, 5, "flags") != 0) {
+				continue;
+			}
+			// Flags are space-separated; pad so we only match whole words.
+			return (line + " ").find(" " + flag + " ") != std::string::npos;
+		}
+		return false;
+	}
+
+	/**Detect whether the TSC is constant and invariant.
+	 * \return the TSC traits for this host
+	 */
+	TscTraits detect_tsc_traits()
+	{
+		TscTraits traits;
+#if GOLDILOCKS_HAS_TSC
+		uint32_t eax, ebx, ecx, edx;
+		// Leaf 0x80000007, EDX bit 8 is the invariant TSC.
+		if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) &&
+			(edx & (1u << 8))) {
+			traits.invariant = true;
+		}
+		// An invariant TSC is always constant-rate.
+		traits.constant = traits.invariant || cpuinfo_has_flag("constant_tsc");
+#endif
+		return traits;
+	}
+
+	/// Get the (cached) TSC traits for this host.
+	const TscTraits& tsc_traits()
+	{
+		static const TscTraits traits = detect_tsc_traits();
+		return traits;
+	}
+
+#if GOLDILOCKS_HAS_TSC
+	/**Ask the CPU (or hypervisor) for the TSC frequency.
+	 * \param [out] which CPUID leaf the frequency came from
+	 * \return the TSC frequency in ticks per nanosecond, or 0 if unknown
+	 */
+	double cpuid_ticks_per_ns(CalibrationMethod& method)
+	{
+		uint32_t eax, ebx, ecx, edx;
+		const uint32_t max_leaf = __get_cpuid_max(0, nullptr);
+
+		/* Leaf 0x15: TSC = crystal * EBX / EAX. The crystal frequency
+		 * (ECX) is zero on some parts, in which case we can't use it. */
+		if (max_leaf >= 0x15) {
+			__cpuid(0x15, eax, ebx, ecx, edx);
+			if (eax != 0 && ebx != 0 && ecx != 0) {
+				method = CalibrationMethod::cpuid_crystal;
+				return ((double)ecx * ebx / eax) / 1e9;
+			}
+		}
+
+		// Leaf 1, ECX bit 31 is set when running under a hypervisor.
+		__cpuid(1, eax, ebx, ecx, edx);
+		if (ecx & (1u << 31)) {
+			// Leaf 0x40000010 (VMware/KVM convention), EAX is TSC in kHz.
+			__cpuid(0x40000000, eax, ebx, ecx, edx);
+			if (eax >= 0x40000010) {
+				__cpuid(0x40000010, eax, ebx, ecx, edx);
+				if (eax != 0) {
+					method = CalibrationMethod::hypervisor;
+					return (double)eax / 1e6;
+				}
+			}
+		}
+
+		// Leaf 0x16: EAX is the base frequency in MHz, which the TSC runs at.
+		if (max_leaf >= 0x16) {
+			__cpuid(0x16, eax, ebx, ecx, edx);
+			if ((eax & 0xFFFF) != 0) {
+				method = CalibrationMethod::cpuid_base_frequency;
+				return (double)(eax & 0xFFFF) / 1e3;
+			}
+		}
+
+		return 0;
+	}
+
+	/**Time the TSC against CLOCK_MONOTONIC_RAW.
+	 * \return the TSC frequency in ticks per nanosecond
+	 */
+	double measure_ticks_per_ns()
+	{
+		double rounds[CALIBRATION_ROUNDS];
+		for (uint32_t round = 0; round < CALIBRATION_ROUNDS; ++round) {
+			uint64_t ns_start = monotonic_raw_now();
+			uint64_t tsc_begin = tsc_stop();
+			uint64_t ns_stop = ns_start;
+			// Spin for the calibration window.
+			while (ns_stop - ns_start < CALIBRATION_WINDOW_NS) {
+				ns_stop = monotonic_raw_now();
+			}
+			uint64_t tsc_end = tsc_stop();
+			rounds[round] = (double)(tsc_end - tsc_begin) / (ns_stop - ns_start);
+		}
+		// Use the median round, in case we were preempted during one.
+		std::sort(rounds, rounds + CALIBRATION_ROUNDS);
+		return rounds[CALIBRATION_ROUNDS / 2];
+	}
+#endif
+
+	/**Calibrate the TSC, preferring what the CPU reports about itself.
+	 * \return the calibration for the TSC
+	 */
+	ClockCalibration calibrate_tsc()
+	{
+		ClockCalibration calibration;
+		calibration.source = ClockSource::tsc;
+		calibration.constant_tsc = tsc_traits().constant;
+		calibration.invariant_tsc = tsc_traits().invariant;
+#if GOLDILOCKS_HAS_TSC
+		double ticks_per_ns = cpuid_ticks_per_ns(calibration.method);
+		if (ticks_per_ns <= 0) {
+			ticks_per_ns = measure_ticks_per_ns();
+			calibration.method = CalibrationMethod::measured;
+		}
+		calibration.ticks_per_ns = ticks_per_ns;
+#endif
+		return calibration;
+	}
+
+	/**Check that a source never runs backwards across successive reads.
+	 * A TSC that is unsynchronized between cores (or badly virtualized)
+	 * will fail this on a busy host.
+	 * \return true if the source appears monotonic, else false
+	 */
+	template<ClockSource S> bool probe_monotonic()
+	{
+		uint64_t last = clock_stop<S>();
+		for (uint32_t i = 0; i < PROBE_SAMPLES; ++i) {
+			uint64_t now = clock_stop<S>();
+			if (now < last) {
+				return false;
+			}
+			last = now;
+		}
+		return true;
+	}
+
+	/**Measure the cost of one empty measurement with a source, in
+	 * nanoseconds of steady_clock, so that sources with different tick
+	 * units can be compared.
+	 * \return the best (lowest) observed cost per measurement
+	 */
+	template<ClockSource S> double probe_overhead()
+	{
+		double best = 0;
+		for (uint32_t round = 0; round < PROBE_ROUNDS; ++round) {
+			uint64_t start = steady_now();
+			for (uint32_t i = 0; i < PROBE_SAMPLES; ++i) {
+				clock_with<S>(nullptr);
+			}
+			double cost = (double)(steady_now() - start) / PROBE_SAMPLES;
+			if (round == 0 || cost < best) {
+				best = cost;
+			}
+		}
+		return best;
+	}
+
+	/**Probe a single source.
+	 * \param the source to probe
+	 * \param [out] the per-measurement overhead, in nanoseconds
+	 * \return true if the source is usable and stable, else false
+	 */
+	bool probe(ClockSource source, double& overhead)
+	{
+		if (!clock_source_available(source)) {
+			return false;
+		}
+		switch (source) {
+#if GOLDILOCKS_HAS_TSC
+			case ClockSource::tsc:
+				/* A TSC that follows frequency scaling doesn't measure
+				 * time, so we won't pick it automatically. */
+				if (!tsc_traits().constant ||
+					!probe_monotonic<ClockSource::tsc>()) {
+					return false;
+				}
+				overhead = probe_overhead<ClockSource::tsc>();
+				return true;
+#endif
+			case ClockSource::monotonic_raw:
+				if (!probe_monotonic<ClockSource::monotonic_raw>()) {
+					return false;
+				}
+				overhead = probe_overhead<ClockSource::monotonic_raw>();
+				return true;
+			case ClockSource::steady:
+				overhead = probe_overhead<ClockSource::steady>();
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	/**Check with the CPU/OS whether a clock source can be used.
+	 * This is expensive (cpuid may trap under a hypervisor), so
+	 * callers should go through clock_source_available() instead.
+	 * \param the clock source to check
+	 * \return true if the source is usable, else false
+	 */
+	bool detect_clock_source(ClockSource source)
+	{
+		switch (source) {
+			case ClockSource::automatic:
+				return true;
+			case ClockSource::tsc: {
+#if GOLDILOCKS_HAS_TSC
+				uint32_t eax, ebx, ecx, edx;
+				// Leaf 1, EDX bit 4 is TSC, and bit 26 is SSE2 (for lfence).
+				if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) ||
+					!(edx & (1u << 4)) || !(edx & (1u << 26))) {
+					return false;
+				}
+				// Leaf 0x80000001, EDX bit 27 is RDTSCP.
+				if (!__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx) ||
+					!(edx & (1u << 27))) {
+					return false;
+				}
+				return true;
+#else
+				return false;
+#endif
+			}
+			case ClockSource::monotonic_raw: {
+#if GOLDILOCKS_HAS_MONOTONIC_RAW
+				timespec ts;
+				return clock_gettime(CLOCK_MONOTONIC_RAW, &ts) == 0;
+#else
+				return false;
+#endif
+			}
+			case ClockSource::steady:
+				return true;
+			default:
+				return false;
+		}
+	}
+}  // namespace
+
+bool clock_source_available(ClockSource source)
+{
+	// Detect only once; clock() checks this on every call.
+	static const bool available[] = {
+		detect_clock_source(ClockSource::automatic),
+		detect_clock_source(ClockSource::tsc),
+		detect_clock_source(ClockSource::monotonic_raw),
+		detect_clock_source(ClockSource::steady)};
+
+	const size_t index = static_cast<size_t>(source);
+	if (index >= sizeof(available) / sizeof(available[0])) {
+		return false;
+	}
+	return available[index];
+}
+
+ClockSource select_clock_source()
+{
+	// Probe only once; the answer won't change while we're running.
+	static const ClockSource selected = []() {
+		// Sources in order of preference, for breaking ties.
+		const ClockSource candidates[] = {
+			ClockSource::tsc, ClockSource::monotonic_raw, ClockSource::steady};
+
+		ClockSource best = ClockSource::steady;
+		double best_overhead = 0;
+		bool found = false;
+
+		for (ClockSource candidate : candidates) {
+			double overhead = 0;
+			if (!probe(candidate, overhead)) {
+				continue;
+			}
+			/* An invariant TSC is the best source we have whatever one
+			 * noisy probe says, so take it without comparing; otherwise
+			 * the units of the results could change from run to run. */
+			if (candidate == ClockSource::tsc && tsc_traits().invariant) {
+				return candidate;
+			}
+			/* A later source has to be clearly cheaper to win, so that
+			 * noise in the probe can't flip the choice between runs. */
+			if (!found || overhead < best_overhead * SWITCH_MARGIN) {
+				best = candidate;
+				best_overhead = overhead;
+				found = true;
+			}
+		}
+		return best;
+	}();
+
+	return selected;
+}
+
+ClockSource resolve_clock_source(ClockSource source)
+{
+	if (source == ClockSource::automatic || !clock_source_available(source)) {
+		return select_clock_source();
+	}
+	return source;
+}
+
+ClockCalibration calibrate_clock(ClockSource source)
+{
+	source = resolve_clock_source(source);
+
+	if (source == ClockSource::tsc) {
+		// Calibrate only once; this can take tens of milliseconds.
+		static const ClockCalibration tsc_calibration = calibrate_tsc();
+		return tsc_calibration;
+	}
+
+	// Every other source already counts nanoseconds.
+	ClockCalibration calibration;
+	calibration.source = source;
+	calibration.method = CalibrationMethod::native;
+	calibration.ticks_per_ns = 1.0;
+	calibration.constant_tsc = tsc_traits().constant;
+	calibration.invariant_tsc = tsc_traits().invariant;
+	return calibration;
+}
+
+const char* clock_source_name(ClockSource source)
+{
+	switch (source) {
+		case ClockSource::automatic:
+			return "automatic";
+		case ClockSource::tsc:
+			return "tsc";
+		case ClockSource::monotonic_raw:
+			return "monotonic_raw";
+		case ClockSource::steady:
+			return "steady_clock";
+		default:
+			return "unknown";
+	}
+}
@@ -0,0 +1,306 @@
+#include "goldilocks/hdr_histogram.hpp"
+
+#include <algorithm>  // std::fill, std::min, std::max
+#include <cmath>      // ceil, log2, pow, sqrt
+#include <stdexcept>  // std::invalid_argument
+
+namespace {
+	/// Marks the start of a serialized histogram.
+	const char SERIAL_MAGIC = 'H';
+
+	/// The serialization format version.
+	const char SERIAL_VERSION = 2;
+
+	/**Append an unsigned LEB128 variable-length integer.
+	 * \param the string to append to
+	 * \param the value to encode
+	 */
+	void put_varint(std::string& out, uint64_t value)
+	{
+		while (value >= 0x80) {
+			out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<char>(value));
+	}
+
+	/**Read an unsigned LEB128 variable-length integer.
+	 * \param the string to read from
+	 * \param [in,out] the position to read at
+	 * \return the decoded value
+	 * \throw std::invalid_argument if the data is truncated or too long
+	 */
+	uint64_t get_varint(const std::string& in, size_t& pos)
+	{
+		uint64_t value = 0;
+		for (uint32_t shift = 0; shift < 64; shift += 7) {
+			if (pos >= in.size()) {
+				throw std::invalid_argument("Truncated histogram data");
+			}
+			uint8_t byte = static_cast<uint8_t>(in[pos++]);
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80)) {
+				return value;
+			}
+		}
+		throw std::invalid_argument("Malformed histogram data");
+	}
+
+	/**Zigzag-encode a signed value, so that small magnitudes of either
+	 * sign stay small as varints. Runs of empty sub-buckets are stored
+	 * as negative lengths.
+	 * \param the signed value
+	 * \return the encoded value
+	 */
+	uint64_t zigzag(int64_t value)
+	{
+		return (static_cast<uint64_t>(value) << 1) ^
+			   static_cast<uint64_t>(value >> 63);
+	}
+
+	/**Undo zigzag().
+	 * \param the encoded value
+	 * \return the signed value
+	 */
+	int64_t unzigzag(uint64_t value)
+	{
+		return static_cast<int64_t>(value >> 1) ^
+			   -static_cast<int64_t>(value & 1);
+	}
+}  // namespace
+
+HdrHistogram::HdrHistogram(uint64_t highest_trackable,
+						   uint8_t significant_figures)
+: highest_trackable(highest_trackable), significant_figures(significant_figures)
+{
+	if (significant_figures < 1 || significant_figures > 5) {
+		throw std::invalid_argument("Significant figures must be 1 to 5");
+	}
+	if (highest_trackable < 2) {
+		throw std::invalid_argument("Highest trackable value must be >= 2");
+	}
+
+	/* Each bucket needs enough sub-buckets to tell apart every value
+	 * up to 2 * 10^figures at unit resolution. */
+	const double single_unit_range = 2 * std::pow(10.0, significant_figures);
+	const uint32_t sub_bucket_count_magnitude =
+		static_cast<uint32_t>(std::ceil(std::log2(single_unit_range)));
+	const uint64_t sub_bucket_count = 1ULL << sub_bucket_count_magnitude;
+
+	this->sub_bucket_half_count_magnitude = sub_bucket_count_magnitude - 1;
+	this->sub_bucket_half_count = sub_bucket_count / 2;
+	this->sub_bucket_mask = sub_bucket_count - 1;
+
+	// Each further bucket doubles the range covered.
+	uint64_t smallest_untrackable = sub_bucket_count;
+	this->bucket_count = 1;
+	while (smallest_untrackable <= highest_trackable) {
+		if (smallest_untrackable > (UINT64_MAX >> 2)) {
+			++this->bucket_count;
+			break;
+		}
+		smallest_untrackable <<= 1;
+		++this->bucket_count;
+	}
+
+	this->counts.assign(
+		(this->bucket_count + 1) * this->sub_bucket_half_count, 0);
+}
+
+uint64_t HdrHistogram::value_at_index(size_t index) const
+{
+	int64_t bucket =
+		static_cast<int64_t>(index >> this->sub_bucket_half_count_magnitude) -
+		1;
+	uint64_t sub_bucket = (index & (this->sub_bucket_half_count - 1)) +
+						  this->sub_bucket_half_count;
+	// The first bucket uses its lower half too.
+	if (bucket < 0) {
+		sub_bucket -= this->sub_bucket_half_count;
+		bucket = 0;
+	}
+	return sub_bucket << bucket;
+}
+
+uint64_t HdrHistogram::equivalent_range(uint64_t value) const
+{
+	return 1ULL << this->bucket_index(value);
+}
+
+void HdrHistogram::merge(const HdrHistogram& other)
+{
+	if (other.highest_trackable != this->highest_trackable ||
+		other.significant_figures != this->significant_figures) {
+		throw std::invalid_argument("Histograms are configured differently");
+	}
+	for (size_t i = 0; i < this->counts.size(); ++i) {
+		this->counts[i] += other.counts[i];
+	}
+	this->total += other.total;
+	this->clamped += other.clamped;
+	this->min_val = std::min(this->min_val, other.min_val);
+	this->max_val = std::max(this->max_val, other.max_val);
+}
+
+void HdrHistogram::reset()
+{
+	std::fill(this->counts.begin(), this->counts.end(), 0);
+	this->total = 0;
+	this->clamped = 0;
+	this->min_val = UINT64_MAX;
+	this->max_val = 0;
+}
+
+uint64_t HdrHistogram::percentile(double percent) const
+{
+	if (this->total == 0) {
+		return 0;
+	}
+	percent = std::min(std::max(percent, 0.0), 100.0);
+
+	/* The rank of the sample we want, counting from 1. Round rather than
+	 * take the ceiling, so floating-point error can't skip a rank. */
+	uint64_t rank =
+		static_cast<uint64_t>(percent / 100.0 * this->total + 0.5);
+	rank = std::max(rank, static_cast<uint64_t>(1));
+
+	uint64_t seen = 0;
+	for (size_t i = 0; i < this->counts.size(); ++i) {
+		seen += this->counts[i];
+		if (seen >= rank) {
+			uint64_t lowest = this->value_at_index(i);
+			uint64_t highest = lowest + this->equivalent_range(lowest) - 1;
+			// Never report beyond what we actually observed.
+			return std::max(std::min(highest, this->max_val), this->min_val);
+		}
+	}
+	return this->max_val;
+}
+
+uint64_t HdrHistogram::count_between(uint64_t low, uint64_t high) const
+{
+	if (low > high || this->total == 0) {
+		return 0;
+	}
+	high = std::min(high, this->highest_trackable);
+	low = std::min(low, high);
+
+	uint64_t count = 0;
+	const size_t last = this->counts_index(high);
+	for (size_t i = this->counts_index(low); i <= last; ++i) {
+		count += this->counts[i];
+	}
+	return count;
+}
+
+uint64_t HdrHistogram::moments_between(uint64_t low,
+									   uint64_t high,
+									   double& mean,
+									   double& std_dev) const
+{
+	mean = 0;
+	std_dev = 0;
+	if (low > high || this->total == 0) {
+		return 0;
+	}
+	high = std::min(high, this->highest_trackable);
+	low = std::min(low, high);
+
+	const size_t first = this->counts_index(low);
+	const size_t last = this->counts_index(high);
+
+	/* Each sub-bucket stands in for its midpoint. Use a weighted Welford
+	 * update so that large counts don't lose precision. */
+	uint64_t count = 0;
+	double m2 = 0;
+	for (size_t i = first; i <= last; ++i) {
+		if (this->counts[i] == 0) {
+			continue;
+		}
+		uint64_t lowest = this->value_at_index(i);
+		double value = lowest + (this->equivalent_range(lowest) - 1) / 2.0;
+		count += this->counts[i];
+		double delta = value - mean;
+		mean += delta * this->counts[i] / count;
+		m2 += delta * (value - mean) * this->counts[i];
+	}
+	if (count > 1) {
+		std_dev = sqrt(m2 / (count - 1));
+	}
+	return count;
+}
+
+std::string HdrHistogram::serialize() const
+{
+	std::string out;
+	out.push_back(SERIAL_MAGIC);
+	out.push_back(SERIAL_VERSION);
+	out.push_back(static_cast<char>(this->significant_figures));
+	put_varint(out, this->highest_trackable);
+	put_varint(out, this->clamped);
+	put_varint(out, this->min_val);
+	put_varint(out, this->max_val);
+	// The total lets deserialize() tell when the counts were cut short.
+	put_varint(out, this->total);
+
+	// Trailing empty sub-buckets are implied, so stop at the last count.
+	size_t end = this->counts.size();
+	while (end > 0 && this->counts[end - 1] == 0) {
+		--end;
+	}
+
+	size_t i = 0;
+	while (i < end) {
+		if (this->counts[i] != 0) {
+			put_varint(out, zigzag(static_cast<int64_t>(this->counts[i])));
+			++i;
+			continue;
+		}
+		// A run of empty sub-buckets is stored as its negated length.
+		size_t run = i;
+		while (run < end && this->counts[run] == 0) {
+			++run;
+		}
+		put_varint(out, zigzag(-static_cast<int64_t>(run - i)));
+		i = run;
+	}
+	return out;
+}
+
+HdrHistogram HdrHistogram::deserialize(const std::string& in)
+{
+	if (in.size() < 3 || in[0] != SERIAL_MAGIC || in[1] != SERIAL_VERSION) {
+		throw std::invalid_argument("Not a serialized histogram");
+	}
+	size_t pos = 2;
+	uint8_t figures = static_cast<uint8_t>(in[pos++]);
+	uint64_t highest = get_varint(in, pos);
+
+	HdrHistogram histogram(highest, figures);
+	histogram.clamped = get_varint(in, pos);
+	histogram.min_val = get_varint(in, pos);
+	histogram.max_val = get_varint(in, pos);
+	uint64_t expected = get_varint(in, pos);
+
+	size_t i = 0;
+	while (pos < in.size()) {
+		int64_t entry = unzigzag(get_varint(in, pos));
+		if (entry < 0) {
+			uint64_t run = static_cast<uint64_t>(-entry);
+			if (run > histogram.counts.size() - i) {
+				throw std::invalid_argument("Malformed histogram data");
+			}
+			i += run;
+			continue;
+		}
+		if (i >= histogram.counts.size()) {
+			throw std::invalid_argument("Malformed histogram data");
+		}
+		histogram.counts[i++] = static_cast<uint64_t>(entry);
+		histogram.total += static_cast<uint64_t>(entry);
+	}
+	if (histogram.total != expected) {
+		throw std::invalid_argument("Truncated histogram data");
+	}
+	return histogram;
+}
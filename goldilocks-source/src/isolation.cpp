@@ -0,0 +1,251 @@
+#include "goldilocks/isolation.hpp"
+
+#include <cstdio>    // fflush
+#include <iostream>  // std::cout, std::cerr
+
+#include "goldilocks/clock.hpp"
+
+#if GOLDILOCKS_HAS_FORK
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>   // errno, EINTR
+#include <csignal>  // kill, SIGKILL
+#include <cstring>  // memcpy, strsignal
+#endif
+
+#if defined __linux__
+#include <sched.h>
+#endif
+
+namespace {
+	/// How many bytes to read from a child at a time.
+	const size_t READ_BLOCK = 1 << 16;
+
+	/// The exit code of a child whose benchmark threw an exception.
+	const int EXIT_THREW = 3;
+
+	/// The size of a record's header: its tag, then its length.
+	const size_t HEADER = 1 + sizeof(uint32_t);
+}  // namespace
+
+PipeWriter::PipeWriter(int fd) : fd(fd) { this->buffer.reserve(BLOCK * 2); }
+
+bool PipeWriter::flush()
+{
+#if GOLDILOCKS_HAS_FORK
+	size_t written = 0;
+	while (written < this->buffer.size()) {
+		ssize_t n = ::write(this->fd,
+							this->buffer.data() + written,
+							this->buffer.size() - written);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			this->buffer.clear();
+			return false;
+		}
+		written += static_cast<size_t>(n);
+	}
+#endif
+	this->buffer.clear();
+	return true;
+}
+
+bool ChildProcess::spawn(const std::function<int(int)>& body, int cpu)
+{
+#if GOLDILOCKS_HAS_FORK
+	int fds[2];
+	if (pipe(fds) != 0) {
+		return false;
+	}
+
+	// Anything still buffered would otherwise be printed by both of us.
+	std::cout.flush();
+	std::cerr.flush();
+	fflush(nullptr);
+
+	this->pid = fork();
+	if (this->pid < 0) {
+		close(fds[0]);
+		close(fds[1]);
+		return false;
+	}
+
+	if (this->pid == 0) {
+		close(fds[0]);
+#if defined __linux__
+		if (cpu >= 0) {
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET(cpu, &set);
+			sched_setaffinity(0, sizeof(set), &set);
+		}
+#else
+		(void)cpu;
+#endif
+		int code = EXIT_THREW;
+		try {
+			code = body(fds[1]);
+		} catch (...) {
+			// Any exception fails the benchmark, not the whole program.
+		}
+		close(fds[1]);
+		std::cout.flush();
+		// Skip the parent's atexit handlers and static destructors.
+		_exit(code);
+	}
+
+	close(fds[1]);
+	this->fd = fds[0];
+	this->pending.clear();
+	this->timed_out = false;
+	return true;
+#else
+	(void)body;
+	(void)cpu;
+	return false;
+#endif
+}
+
+bool ChildProcess::read_all(
+	std::vector<ChildProcess*>& children,
+	uint64_t timeout_ns,
+	const std::function<void(size_t, char, const std::string&)>& on_record)
+{
+#if GOLDILOCKS_HAS_FORK
+	const uint64_t start = steady_now();
+	std::vector<char> block(READ_BLOCK);
+	for (;;) {
+		std::vector<pollfd> polls;
+		std::vector<size_t> owners;
+		for (size_t i = 0; i < children.size(); ++i) {
+			if (children[i]->fd >= 0) {
+				polls.push_back({children[i]->fd, POLLIN, 0});
+				owners.push_back(i);
+			}
+		}
+		if (polls.empty()) {
+			return true;
+		}
+
+		int wait_ms = -1;
+		if (timeout_ns != 0) {
+			const uint64_t elapsed = steady_now() - start;
+			if (elapsed >= timeout_ns) {
+				// Out of time: stop whatever is still running.
+				for (size_t i : owners) {
+					kill(children[i]->pid, SIGKILL);
+					children[i]->timed_out = true;
+					close(children[i]->fd);
+					children[i]->fd = -1;
+				}
+				return false;
+			}
+			// Round up, so we never spin on a sub-millisecond remainder.
+			wait_ms =
+				static_cast<int>((timeout_ns - elapsed + 999999) / 1000000);
+		}
+
+		if (poll(polls.data(), polls.size(), wait_ms) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+
+		for (size_t p = 0; p < polls.size(); ++p) {
+			if (polls[p].revents == 0) {
+				continue;
+			}
+			ChildProcess& child = *children[owners[p]];
+			ssize_t n = read(child.fd, block.data(), block.size());
+			if (n < 0 && errno == EINTR) {
+				continue;
+			}
+			if (n <= 0) {
+				// The child closed its end: it is done, or dead.
+				close(child.fd);
+				child.fd = -1;
+				continue;
+			}
+			child.pending.append(block.data(), static_cast<size_t>(n));
+
+			// Hand over every whole record.
+			size_t at = 0;
+			while (child.pending.size() - at >= HEADER) {
+				uint32_t size;
+				memcpy(&size, &child.pending[at + 1], sizeof(size));
+				if (child.pending.size() - at < HEADER + size) {
+					break;
+				}
+				on_record(owners[p],
+						  child.pending[at],
+						  child.pending.substr(at + HEADER, size));
+				at += HEADER + size;
+			}
+			child.pending.erase(0, at);
+		}
+	}
+#else
+	(void)children;
+	(void)timeout_ns;
+	(void)on_record;
+	return false;
+#endif
+}
+
+ChildExit ChildProcess::wait()
+{
+	ChildExit result;
+#if GOLDILOCKS_HAS_FORK
+	if (this->pid <= 0) {
+		result.reason = "the child process never started";
+		return result;
+	}
+	if (this->fd >= 0) {
+		close(this->fd);
+		this->fd = -1;
+	}
+
+	int status = 0;
+	while (waitpid(this->pid, &status, 0) < 0) {
+		if (errno != EINTR) {
+			result.reason = "the child process was lost";
+			this->pid = -1;
+			return result;
+		}
+	}
+	this->pid = -1;
+
+	if (this->timed_out) {
+		result.reason = "timed out";
+	} else if (WIFSIGNALED(status)) {
+		result.reason = "crashed with signal " +
+						std::to_string(WTERMSIG(status)) + " (" +
+						strsignal(WTERMSIG(status)) + ")";
+	} else if (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_THREW) {
+		result.reason = "threw an exception";
+	} else if (WIFEXITED(status) && WEXITSTATUS(status) != 0) {
+		result.reason = "failed";
+	} else {
+		result.succeeded = true;
+	}
+#else
+	result.reason = "child processes are not supported on this platform";
+#endif
+	return result;
+}
+
+ChildProcess::~ChildProcess()
+{
+#if GOLDILOCKS_HAS_FORK
+	// Never leave a child behind, even if we gave up on it.
+	if (this->pid > 0) {
+		kill(this->pid, SIGKILL);
+		this->wait();
+	}
+#endif
+}
@@ -0,0 +1,308 @@
+#include "goldilocks/modality.hpp"
+
+#include <algorithm>  // std::max, std::min
+#include <cmath>      // ceil, exp, log, pow, sqrt
+
+namespace {
+	/// How many bins the density is estimated over.
+	const size_t GRID = 1024;
+
+	/// The smallest share of the samples that can make up a mode.
+	const double MIN_MODE_WEIGHT = 0.01;
+
+	/** The fewest samples that can make up a mode, however many there
+	 * are, so that a few strays in a short run don't count as one.*/
+	const double MIN_MODE_SAMPLES = 20;
+
+	/** How far the density must dip between two peaks, as a fraction of
+	 * the lower peak, for them to count as separate modes.*/
+	const double MAX_VALLEY = 0.5;
+
+	/** How many bandwidths out the kernel reaches. The Gaussian is
+	 * negligible beyond this.*/
+	const double KERNEL_REACH = 4;
+
+	/** Builds the shape of a distribution from its samples, which may
+	 * arrive with counts (as from a histogram).*/
+	class ShapeBuilder
+	{
+	private:
+		/// The logarithm of the smallest sample, where the grid starts.
+		double log_min;
+
+		/// The width of each bin of the grid, in log space.
+		double bin_width;
+
+		/// The mean of the samples, which the moments are taken around.
+		double mean;
+
+		/// The number of samples.
+		double n = 0;
+
+		/// The sums of the 2nd, 3rd and 4th powers of deviations.
+		double m2 = 0, m3 = 0, m4 = 0;
+
+		/// The sums of log deviations from log_min, and their squares.
+		double log_sum = 0, log_sum_sq = 0;
+
+		/// The samples in each bin of the grid.
+		std::vector<double> bins;
+
+		/**Find the logarithm of a sample, treating 0 as 1 tick.
+		 * \param the sample
+		 * \return its logarithm
+		 */
+		static double safe_log(double x) { return log(std::max(x, 1.0)); }
+
+		/**Turn a position on the grid back into ticks.
+		 * \param the position, in bins
+		 * \return the value in ticks
+		 */
+		double value_at(double position) const
+		{
+			return exp(this->log_min + position * this->bin_width);
+		}
+
+		/**Estimate the density over the grid.
+		 * \return the density in each bin
+		 */
+		std::vector<double> density() const;
+
+		/**Find the modes in a density.
+		 * \param the density in each bin
+		 * \return the modes
+		 */
+		std::vector<DistributionMode>
+			find_modes(const std::vector<double>&) const;
+
+	public:
+		/* Ctor
+		 * \param min The smallest sample
+		 * \param max The largest sample
+		 * \param mean The mean of the samples
+		 */
+		ShapeBuilder(double min, double max, double mean)
+		: log_min(safe_log(min)),
+		  bin_width((safe_log(max) - safe_log(min)) / GRID),
+		  mean(mean),
+		  bins(GRID, 0)
+		{
+		}
+
+		/**Add a sample.
+		 * \param the sample
+		 * \param how many times it occurred
+		 */
+		void add(double x, double count)
+		{
+			const double d = x - this->mean;
+			const double d2 = d * d;
+			this->n += count;
+			this->m2 += count * d2;
+			this->m3 += count * d2 * d;
+			this->m4 += count * d2 * d2;
+
+			// Histogram midpoints can fall just outside the extremes.
+			const double l = std::max(safe_log(x) - this->log_min, 0.0);
+			this->log_sum += count * l;
+			this->log_sum_sq += count * l * l;
+			size_t bin = 0;
+			if (this->bin_width > 0) {
+				bin = std::min(static_cast<size_t>(l / this->bin_width),
+							   GRID - 1);
+			}
+			this->bins[bin] += count;
+		}
+
+		/**Finish the analysis.
+		 * \return the shape of the samples
+		 */
+		Modality finish() const;
+	};
+
+	std::vector<double> ShapeBuilder::density() const
+	{
+		// Find the log-space spread, for Silverman's rule of thumb.
+		const double log_mean = this->log_sum / this->n;
+		const double log_var = std::max(
+			this->log_sum_sq / this->n - log_mean * log_mean, 0.0);
+		double spread = sqrt(log_var);
+
+		// The interquartile range is more robust, when there is one.
+		double seen = 0;
+		double q1 = -1, q3 = -1;
+		for (size_t i = 0; i < GRID; ++i) {
+			seen += this->bins[i];
+			if (q1 < 0 && seen >= this->n / 4) {
+				q1 = i;
+			}
+			if (q3 < 0 && seen >= this->n * 3 / 4) {
+				q3 = i;
+			}
+		}
+		const double iqr = (q3 - q1) * this->bin_width / 1.34;
+		if (iqr > 0) {
+			spread = std::min(spread, iqr);
+		}
+
+		// The bandwidth, in bins, but never narrower than a bin.
+		const double h = std::max(
+			0.9 * spread * pow(this->n, -0.2) / this->bin_width, 1.0);
+		const size_t reach = std::min(
+			static_cast<size_t>(ceil(h * KERNEL_REACH)), GRID - 1);
+
+		std::vector<double> kernel(reach + 1);
+		for (size_t k = 0; k <= reach; ++k) {
+			kernel[k] = exp(-0.5 * (k / h) * (k / h));
+		}
+
+		// Spread each bin over its neighbours.
+		std::vector<double> result(GRID, 0);
+		for (size_t j = 0; j < GRID; ++j) {
+			if (this->bins[j] == 0) {
+				continue;
+			}
+			const size_t first = (j > reach) ? j - reach : 0;
+			const size_t last = std::min(j + reach, GRID - 1);
+			for (size_t i = first; i <= last; ++i) {
+				const size_t k = (i > j) ? i - j : j - i;
+				result[i] += this->bins[j] * kernel[k];
+			}
+		}
+		return result;
+	}
+
+	std::vector<DistributionMode> ShapeBuilder::find_modes(
+		const std::vector<double>& density) const
+	{
+		// Every local maximum is a candidate. Plateaus count once.
+		std::vector<size_t> peaks;
+		for (size_t i = 0; i < GRID; ++i) {
+			const bool rising = (i == 0 || density[i] > density[i - 1]);
+			const bool falling =
+				(i == GRID - 1 || density[i] >= density[i + 1]);
+			if (rising && falling && density[i] > 0) {
+				peaks.push_back(i);
+			}
+		}
+
+		auto valley = [&](size_t left, size_t right) -> size_t {
+			size_t lowest = left;
+			for (size_t i = left; i <= right; ++i) {
+				if (density[i] < density[lowest]) {
+					lowest = i;
+				}
+			}
+			return lowest;
+		};
+
+		// Merge peaks that the density doesn't dip far enough between.
+		std::vector<size_t> kept;
+		for (size_t peak : peaks) {
+			if (!kept.empty()) {
+				const size_t last = kept.back();
+				const double lower = std::min(density[last], density[peak]);
+				if (density[valley(last, peak)] > MAX_VALLEY * lower) {
+					if (density[peak] > density[last]) {
+						kept.back() = peak;
+					}
+					continue;
+				}
+			}
+			kept.push_back(peak);
+		}
+
+		/* Split the grid at the valleys between peaks, and drop the
+		 * smallest mode until every mode carries enough weight. */
+		const double min_samples =
+			std::max(MIN_MODE_WEIGHT * this->n, MIN_MODE_SAMPLES);
+		std::vector<DistributionMode> modes;
+		while (!kept.empty()) {
+			std::vector<size_t> bounds = {0};
+			for (size_t i = 1; i < kept.size(); ++i) {
+				bounds.push_back(valley(kept[i - 1], kept[i]));
+			}
+			bounds.push_back(GRID);
+
+			modes.assign(kept.size(), DistributionMode());
+			size_t smallest = 0;
+			for (size_t m = 0; m < kept.size(); ++m) {
+				double weight = 0;
+				for (size_t i = bounds[m]; i < bounds[m + 1]; ++i) {
+					weight += this->bins[i];
+				}
+				modes[m].location = this->value_at(kept[m] + 0.5);
+				modes[m].low = this->value_at(bounds[m]);
+				modes[m].high = this->value_at(bounds[m + 1]);
+				modes[m].weight = weight / this->n;
+				if (modes[m].weight < modes[smallest].weight) {
+					smallest = m;
+				}
+			}
+			if (kept.size() == 1 ||
+				modes[smallest].weight * this->n >= min_samples) {
+				break;
+			}
+			kept.erase(kept.begin() + smallest);
+		}
+		return modes;
+	}
+
+	Modality ShapeBuilder::finish() const
+	{
+		Modality shape;
+		if (this->n == 0) {
+			return shape;
+		}
+
+		// Identical samples have one mode, and no shape to speak of.
+		if (this->m2 == 0 || this->bin_width == 0) {
+			DistributionMode mode;
+			mode.location = mode.low = mode.high = this->mean;
+			mode.weight = 1;
+			shape.modes.push_back(mode);
+			return shape;
+		}
+
+		/* The bias-corrected skewness and excess kurtosis, and Sarle's
+		 * bimodality coefficient from them. */
+		const double n = this->n;
+		if (n > 3) {
+			const double var = this->m2 / n;
+			const double g1 = (this->m3 / n) / pow(var, 1.5);
+			const double g2 = (this->m4 / n) / (var * var) - 3;
+			shape.skewness = g1 * sqrt(n * (n - 1)) / (n - 2);
+			shape.kurtosis =
+				(n - 1) / ((n - 2) * (n - 3)) * ((n + 1) * g2 + 6);
+			shape.bimodality =
+				(shape.skewness * shape.skewness + 1) /
+				(shape.kurtosis + 3 * (n - 1) * (n - 1) / ((n - 2) * (n - 3)));
+		}
+
+		shape.modes = this->find_modes(this->density());
+		return shape;
+	}
+}  // namespace
+
+Modality analyze_modality(const uint64_t* samples,
+						  size_t n,
+						  uint64_t min,
+						  uint64_t max,
+						  double mean)
+{
+	ShapeBuilder builder(min, max, mean);
+	for (size_t i = 0; i < n; ++i) {
+		builder.add(static_cast<double>(samples[i]), 1);
+	}
+	return builder.finish();
+}
+
+Modality analyze_modality(const HdrHistogram& histogram)
+{
+	double mean = 0, std_dev = 0;
+	histogram.moments_between(0, UINT64_MAX, mean, std_dev);
+	ShapeBuilder builder(histogram.min(), histogram.max(), mean);
+	histogram.for_each_bucket(
+		[&](double value, uint64_t count) { builder.add(value, count); });
+	return builder.finish();
+}
@@ -0,0 +1,252 @@
+#include "goldilocks/perf_counters.hpp"
+
+#include <algorithm>  // std::max
+#include <cmath>      // INFINITY, NAN, isfinite
+
+#if GOLDILOCKS_HAS_PERF
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>  // memset
+#endif
+
+namespace {
+	/// The groups counters are opened in.
+	const size_t HARDWARE = 0;
+	const size_t SOFTWARE = 1;
+}  // namespace
+
+const char* counter_name(Counter counter)
+{
+	switch (counter) {
+		case Counter::instructions:
+			return "instructions";
+		case Counter::cycles:
+			return "cycles";
+		case Counter::cache_references:
+			return "cache references";
+		case Counter::cache_misses:
+			return "cache misses";
+		case Counter::branch_misses:
+			return "branch misses";
+		case Counter::task_clock:
+			return "task clock (ns)";
+		case Counter::page_faults:
+			return "page faults";
+		case Counter::context_switches:
+			return "context switches";
+		case Counter::allocations:
+			return "allocations";
+		case Counter::frees:
+			return "frees";
+		case Counter::allocated_bytes:
+			return "bytes allocated";
+		default:
+			return "unknown";
+	}
+}
+
+CounterGroup::CounterGroup()
+{
+	this->fds.fill(-1);
+	this->baseline.fill(0);
+}
+
+void CounterGroup::open_counter(Counter counter,
+								size_t group,
+								uint32_t type,
+								uint64_t config)
+{
+#if GOLDILOCKS_HAS_PERF
+	perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	// Members follow the leader, which starts disabled until start().
+	attr.disabled = (this->leaders[group] < 0) ? 1 : 0;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+					   PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	/* Software events like context switches happen in the kernel, so
+	 * try to count it, but settle for user space if we aren't allowed.
+	 * Hardware events are only wanted for the test's own code. */
+	int fd = -1;
+	for (int user_only = (group == HARDWARE) ? 1 : 0; user_only <= 1;
+		 ++user_only) {
+		attr.exclude_kernel = user_only;
+		fd = static_cast<int>(syscall(
+			__NR_perf_event_open, &attr, 0, -1, this->leaders[group], 0));
+		if (fd >= 0) {
+			break;
+		}
+	}
+	if (fd < 0) {
+		return;
+	}
+
+	if (this->leaders[group] < 0) {
+		this->leaders[group] = fd;
+	}
+	this->fds[static_cast<size_t>(counter)] = fd;
+	this->members[group][this->sizes[group]++] = counter;
+#else
+	(void)counter;
+	(void)group;
+	(void)type;
+	(void)config;
+#endif
+}
+
+uint32_t CounterGroup::open()
+{
+#if GOLDILOCKS_HAS_PERF
+	open_counter(Counter::instructions,
+				 HARDWARE,
+				 PERF_TYPE_HARDWARE,
+				 PERF_COUNT_HW_INSTRUCTIONS);
+	open_counter(Counter::cycles,
+				 HARDWARE,
+				 PERF_TYPE_HARDWARE,
+				 PERF_COUNT_HW_CPU_CYCLES);
+	open_counter(Counter::cache_references,
+				 HARDWARE,
+				 PERF_TYPE_HARDWARE,
+				 PERF_COUNT_HW_CACHE_REFERENCES);
+	open_counter(Counter::cache_misses,
+				 HARDWARE,
+				 PERF_TYPE_HARDWARE,
+				 PERF_COUNT_HW_CACHE_MISSES);
+	open_counter(Counter::branch_misses,
+				 HARDWARE,
+				 PERF_TYPE_HARDWARE,
+				 PERF_COUNT_HW_BRANCH_MISSES);
+	open_counter(Counter::task_clock,
+				 SOFTWARE,
+				 PERF_TYPE_SOFTWARE,
+				 PERF_COUNT_SW_TASK_CLOCK);
+	open_counter(Counter::page_faults,
+				 SOFTWARE,
+				 PERF_TYPE_SOFTWARE,
+				 PERF_COUNT_SW_PAGE_FAULTS);
+	open_counter(Counter::context_switches,
+				 SOFTWARE,
+				 PERF_TYPE_SOFTWARE,
+				 PERF_COUNT_SW_CONTEXT_SWITCHES);
+#endif
+	uint32_t mask = 0;
+	for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+		if (this->fds[i] >= 0) {
+			mask |= counter_bit(static_cast<Counter>(i));
+		}
+	}
+	return mask;
+}
+
+void CounterGroup::calibrate(ClockSource source, uint32_t samples)
+{
+	this->baseline.fill(0);
+	CounterValues lowest;
+	lowest.fill(INFINITY);
+	for (uint32_t i = 0; i < samples; ++i) {
+		CounterValues values;
+		this->start();
+		clock(nullptr, source);
+		this->stop();
+		this->read(values);
+		// The least is what's always there, and not noise.
+		for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+			if (values[c] < lowest[c]) {
+				lowest[c] = values[c];
+			}
+		}
+	}
+	// A counter that never got onto the PMU has nothing to take off.
+	for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+		this->baseline[c] = std::isfinite(lowest[c]) ? lowest[c] : 0;
+	}
+}
+
+void CounterGroup::start()
+{
+#if GOLDILOCKS_HAS_PERF
+	for (int leader : this->leaders) {
+		if (leader >= 0) {
+			ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+			ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		}
+	}
+#endif
+}
+
+void CounterGroup::stop()
+{
+#if GOLDILOCKS_HAS_PERF
+	for (int leader : this->leaders) {
+		if (leader >= 0) {
+			ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+		}
+	}
+#endif
+}
+
+void CounterGroup::read_group(size_t group, CounterValues& values) const
+{
+#if GOLDILOCKS_HAS_PERF
+	// The group reads as its size, the times, then each member's count.
+	uint64_t buffer[3 + COUNTER_COUNT];
+	const ssize_t expected =
+		static_cast<ssize_t>((3 + this->sizes[group]) * sizeof(uint64_t));
+	if (::read(this->leaders[group], buffer, sizeof(buffer)) != expected) {
+		return;
+	}
+
+	/* If other events crowded this group off the PMU for a while, scale
+	 * its counts up to the whole time it was enabled. If it never got on
+	 * at all (say, the NMI watchdog holds the PMU), it counted nothing,
+	 * which is not the same as counting zero. */
+	const uint64_t enabled = buffer[1];
+	const uint64_t running = buffer[2];
+	if (running == 0) {
+		for (size_t i = 0; i < this->sizes[group]; ++i) {
+			values[static_cast<size_t>(this->members[group][i])] = NAN;
+		}
+		return;
+	}
+	const double scale = (running < enabled)
+							 ? static_cast<double>(enabled) / running
+							 : 1.0;
+	for (size_t i = 0; i < this->sizes[group]; ++i) {
+		const size_t c = static_cast<size_t>(this->members[group][i]);
+		values[c] =
+			std::max(buffer[3 + i] * scale - this->baseline[c], 0.0);
+	}
+#else
+	(void)group;
+	(void)values;
+#endif
+}
+
+void CounterGroup::read(CounterValues& values) const
+{
+	values.fill(0);
+	for (size_t group = HARDWARE; group <= SOFTWARE; ++group) {
+		if (this->leaders[group] >= 0) {
+			this->read_group(group, values);
+		}
+	}
+}
+
+CounterGroup::~CounterGroup()
+{
+#if GOLDILOCKS_HAS_PERF
+	for (int fd : this->fds) {
+		if (fd >= 0) {
+			close(fd);
+		}
+	}
+#endif
+}
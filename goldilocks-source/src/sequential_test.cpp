@@ -0,0 +1,51 @@
+#include "goldilocks/sequential_test.hpp"
+
+#include <cmath>  // fabs, sqrt
+
+#include "goldilocks/statistics.hpp"
+
+namespace {
+	/// The fewest pairs to judge a comparison on, however often we look.
+	const uint64_t MIN_PAIRS = 30;
+}  // namespace
+
+SequentialTest::SequentialTest(EarlyStop mode,
+							   double alpha,
+							   double precision,
+							   uint64_t interval)
+: mode(mode), alpha(alpha), precision(precision), interval(interval)
+{
+	if (this->interval == 0) {
+		this->interval = 1;
+	}
+}
+
+bool SequentialTest::look()
+{
+	if (this->count < MIN_PAIRS) {
+		return false;
+	}
+	++this->looks;
+
+	// This look's share of alpha; the shares sum to alpha (pi^2/6 = sum 1/k^2).
+	const double k = static_cast<double>(this->looks);
+	const double alpha_k = this->alpha * 6 / (M_PI * M_PI * k * k);
+	const double z = normal_quantile(1 - alpha_k / 2);
+
+	const double se = sqrt(this->m2_d / (this->count - 1) / this->count);
+
+	const bool check_significance = (this->mode == EarlyStop::significance ||
+									 this->mode == EarlyStop::either);
+	const bool check_precision = (this->mode == EarlyStop::precision ||
+								  this->mode == EarlyStop::either);
+
+	if (check_significance && fabs(this->mean_d) > z * se) {
+		this->reason = EarlyStop::significance;
+		return true;
+	}
+	if (check_precision && z * se <= this->precision * fabs(this->mean_b)) {
+		this->reason = EarlyStop::precision;
+		return true;
+	}
+	return false;
+}
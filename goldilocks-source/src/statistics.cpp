@@ -0,0 +1,457 @@
+#include "goldilocks/statistics.hpp"
+
+#include <algorithm>  // std::sort, std::max, std::min
+#include <cmath>      // ceil, erfc, exp, fabs, lgamma, log, sqrt
+
+namespace {
+	/// How many continued fraction terms to try in incomplete_beta().
+	const int BETA_MAX_TERMS = 300;
+
+	/// The relative precision to stop the continued fraction at.
+	const double BETA_EPSILON = 3e-16;
+
+	/// Stands in for zero in the continued fraction, to avoid dividing by it.
+	const double BETA_TINY = 1e-300;
+
+	/**Evaluate the continued fraction for the incomplete beta function,
+	 * by the modified Lentz method.
+	 * \param x
+	 * \param a
+	 * \param b
+	 * \return the value of the continued fraction
+	 */
+	double beta_fraction(double x, double a, double b)
+	{
+		const double qab = a + b;
+		const double qap = a + 1;
+		const double qam = a - 1;
+		double c = 1;
+		double d = 1 - qab * x / qap;
+		if (fabs(d) < BETA_TINY) {
+			d = BETA_TINY;
+		}
+		d = 1 / d;
+		double h = d;
+
+		for (int m = 1; m <= BETA_MAX_TERMS; ++m) {
+			const int m2 = 2 * m;
+			// The even step of the recurrence.
+			double aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+			d = 1 + aa * d;
+			if (fabs(d) < BETA_TINY) {
+				d = BETA_TINY;
+			}
+			c = 1 + aa / c;
+			if (fabs(c) < BETA_TINY) {
+				c = BETA_TINY;
+			}
+			d = 1 / d;
+			h *= d * c;
+
+			// The odd step of the recurrence.
+			aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+			d = 1 + aa * d;
+			if (fabs(d) < BETA_TINY) {
+				d = BETA_TINY;
+			}
+			c = 1 + aa / c;
+			if (fabs(c) < BETA_TINY) {
+				c = BETA_TINY;
+			}
+			d = 1 / d;
+			const double delta = d * c;
+			h *= delta;
+			if (fabs(delta - 1) < BETA_EPSILON) {
+				break;
+			}
+		}
+		return h;
+	}
+
+	/**Rank two sorted series together, averaging the ranks of ties.
+	 * \param the sorted series A
+	 * \param the size of A
+	 * \param the sorted series B
+	 * \param the size of B
+	 * \param [out] the sum over tie groups of (t^3 - t)
+	 * \return the sum of the ranks of A
+	 */
+	double rank_sum(const uint64_t* a,
+					size_t n_a,
+					const uint64_t* b,
+					size_t n_b,
+					double& ties)
+	{
+		double sum_a = 0;
+		ties = 0;
+		size_t i = 0, j = 0;
+		// The rank of the next sample, counting from 1.
+		double rank = 1;
+		while (i < n_a || j < n_b) {
+			// Take the smallest remaining value, and every tie of it.
+			uint64_t value;
+			if (j >= n_b || (i < n_a && a[i] <= b[j])) {
+				value = a[i];
+			} else {
+				value = b[j];
+			}
+			size_t tied_a = 0, tied_b = 0;
+			while (i < n_a && a[i] == value) {
+				++i;
+				++tied_a;
+			}
+			while (j < n_b && b[j] == value) {
+				++j;
+				++tied_b;
+			}
+			const double t = static_cast<double>(tied_a + tied_b);
+			// Every tie gets the mean of the ranks they span.
+			sum_a += tied_a * (rank + (t - 1) / 2);
+			ties += t * t * t - t;
+			rank += t;
+		}
+		return sum_a;
+	}
+
+	/**Count U for A shifted down by delta, against B. That is, the
+	 * number of pairs where (a - delta) > b, plus half of the ties.
+	 * \param the sorted series A
+	 * \param the size of A
+	 * \param the sorted series B
+	 * \param the size of B
+	 * \param the shift to take from A
+	 * \return the U statistic of the shifted series
+	 */
+	double shifted_u(const uint64_t* a,
+					 size_t n_a,
+					 const uint64_t* b,
+					 size_t n_b,
+					 double delta)
+	{
+		double u = 0;
+		size_t below = 0, at_or_below = 0;
+		// As a rises, so do the counts of b below it; never look back.
+		for (size_t i = 0; i < n_a; ++i) {
+			const double x = a[i] - delta;
+			while (below < n_b && b[below] < x) {
+				++below;
+			}
+			at_or_below = std::max(at_or_below, below);
+			while (at_or_below < n_b && b[at_or_below] <= x) {
+				++at_or_below;
+			}
+			u += below + (at_or_below - below) / 2.0;
+		}
+		return u;
+	}
+
+	/**Find the shift of A at which U falls to a target, by bisection.
+	 * U only falls as the shift grows.
+	 * \param the sorted series A
+	 * \param the size of A
+	 * \param the sorted series B
+	 * \param the size of B
+	 * \param the target U
+	 * \return the shift
+	 */
+	double solve_shift(const uint64_t* a,
+					   size_t n_a,
+					   const uint64_t* b,
+					   size_t n_b,
+					   double target)
+	{
+		// No shift outside these bounds changes U any further.
+		double low = static_cast<double>(a[0]) - b[n_b - 1];
+		double high = static_cast<double>(a[n_a - 1]) - b[0];
+		// Samples are whole ticks, so a hundredth of a tick is plenty.
+		while (high - low > 0.01) {
+			const double mid = (low + high) / 2;
+			if (shifted_u(a, n_a, b, n_b, mid) > target) {
+				low = mid;
+			} else {
+				high = mid;
+			}
+		}
+		return (low + high) / 2;
+	}
+}  // namespace
+
+const char* verdict_method_name(VerdictMethod method)
+{
+	switch (method) {
+		case VerdictMethod::paired_t:
+			return "paired t-test";
+		case VerdictMethod::welch_t:
+			return "Welch's t-test";
+		case VerdictMethod::mann_whitney:
+			return "Mann-Whitney U test";
+		default:
+			return "unknown";
+	}
+}
+
+const char* outlier_method_name(OutlierMethod method)
+{
+	switch (method) {
+		case OutlierMethod::none:
+			return "none";
+		case OutlierMethod::tukey:
+			return "Tukey";
+		case OutlierMethod::mad:
+			return "MAD";
+		case OutlierMethod::trim:
+			return "trim";
+		default:
+			return "unknown";
+	}
+}
+
+double normal_cdf(double z) { return 0.5 * erfc(-z / sqrt(2.0)); }
+
+double normal_quantile(double p)
+{
+	if (p <= 0) {
+		return -INFINITY;
+	}
+	if (p >= 1) {
+		return INFINITY;
+	}
+
+	/* Acklam's rational approximation, which is good to about 1e-9,
+	 * followed by one step of Halley's method to polish it.*/
+	static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02,
+							   -2.759285104469687e+02, 1.383577518672690e+02,
+							   -3.066479806614716e+01, 2.506628277459239e+00};
+	static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02,
+							   -1.556989798598866e+02, 6.680131188771972e+01,
+							   -1.328068155288572e+01};
+	static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01,
+							   -2.400758277161838e+00, -2.549732539343734e+00,
+							   4.374664141464968e+00,  2.938163982698783e+00};
+	static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01,
+							   2.445134137142996e+00, 3.754408661907416e+00};
+	const double p_low = 0.02425;
+
+	double x;
+	if (p < p_low) {
+		const double q = sqrt(-2 * log(p));
+		x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q +
+			 c[5]) /
+			((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+	} else if (p <= 1 - p_low) {
+		const double q = p - 0.5;
+		const double r = q * q;
+		x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r +
+			 a[5]) *
+			q /
+			(((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+	} else {
+		const double q = sqrt(-2 * log(1 - p));
+		x = -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q +
+			  c[5]) /
+			((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+	}
+
+	const double e = normal_cdf(x) - p;
+	const double u = e * sqrt(2 * M_PI) * exp(x * x / 2);
+	return x - u / (1 + x * u / 2);
+}
+
+double incomplete_beta(double x, double a, double b)
+{
+	if (x <= 0) {
+		return 0;
+	}
+	if (x >= 1) {
+		return 1;
+	}
+	// The prefactor x^a (1-x)^b / (a B(a, b)), in logs to avoid overflow.
+	const double front = exp(lgamma(a + b) - lgamma(a) - lgamma(b) +
+							 a * log(x) + b * log(1 - x));
+	// The continued fraction converges quickly on this side of the mean.
+	if (x < (a + 1) / (a + b + 2)) {
+		return front * beta_fraction(x, a, b) / a;
+	}
+	return 1 - front * beta_fraction(1 - x, b, a) / b;
+}
+
+double student_t_two_sided(double t, double df)
+{
+	if (df <= 0) {
+		return 1;
+	}
+	return incomplete_beta(df / (df + t * t), df / 2, 0.5);
+}
+
+double student_t_critical(double alpha, double df)
+{
+	if (alpha <= 0) {
+		return INFINITY;
+	}
+	if (alpha >= 1) {
+		return 0;
+	}
+	// Bracket the critical value, then bisect; the tail only shrinks.
+	double low = 0;
+	double high = 1;
+	while (student_t_two_sided(high, df) > alpha) {
+		low = high;
+		high *= 2;
+	}
+	for (int i = 0; i < 100 && high - low > 1e-12 * high; ++i) {
+		const double mid = (low + high) / 2;
+		if (student_t_two_sided(mid, df) > alpha) {
+			low = mid;
+		} else {
+			high = mid;
+		}
+	}
+	return (low + high) / 2;
+}
+
+HypothesisTest paired_t_test(double mean_d,
+							 double std_dev_d,
+							 uint64_t pairs,
+							 double alpha)
+{
+	HypothesisTest test;
+	test.method = VerdictMethod::paired_t;
+	test.estimate = mean_d;
+	test.confidence = 1 - alpha;
+	test.ci_low = test.ci_high = mean_d;
+	if (pairs < 2) {
+		return test;
+	}
+
+	test.df = static_cast<double>(pairs - 1);
+	// The standard error of the mean difference.
+	const double se = std_dev_d / sqrt(static_cast<double>(pairs));
+	if (se > 0) {
+		test.statistic = mean_d / se;
+		test.p = student_t_two_sided(test.statistic, test.df);
+		const double margin = student_t_critical(alpha, test.df) * se;
+		test.ci_low = mean_d - margin;
+		test.ci_high = mean_d + margin;
+		test.effect_size = mean_d / std_dev_d;
+	} else {
+		// Every pair differed by exactly the same amount.
+		test.p = (mean_d == 0) ? 1 : 0;
+	}
+	return test;
+}
+
+HypothesisTest welch_t_test(double mean_a,
+							double std_dev_a,
+							uint64_t n_a,
+							double mean_b,
+							double std_dev_b,
+							uint64_t n_b,
+							double alpha)
+{
+	HypothesisTest test;
+	test.method = VerdictMethod::welch_t;
+	test.estimate = mean_a - mean_b;
+	test.confidence = 1 - alpha;
+	test.ci_low = test.ci_high = test.estimate;
+	if (n_a < 2 || n_b < 2) {
+		return test;
+	}
+
+	// The squared standard error of each mean.
+	const double var_a = std_dev_a * std_dev_a / n_a;
+	const double var_b = std_dev_b * std_dev_b / n_b;
+	const double se = sqrt(var_a + var_b);
+	if (se > 0) {
+		test.statistic = test.estimate / se;
+		// The Welch-Satterthwaite approximation of the degrees of freedom.
+		test.df = (var_a + var_b) * (var_a + var_b) /
+				  (var_a * var_a / (n_a - 1) + var_b * var_b / (n_b - 1));
+		test.p = student_t_two_sided(test.statistic, test.df);
+		const double margin = student_t_critical(alpha, test.df) * se;
+		test.ci_low = test.estimate - margin;
+		test.ci_high = test.estimate + margin;
+		// Cohen's d, against the average of the two variances.
+		test.effect_size =
+			test.estimate /
+			sqrt((std_dev_a * std_dev_a + std_dev_b * std_dev_b) / 2);
+	} else {
+		// Neither series varied at all.
+		test.df = static_cast<double>(n_a + n_b - 2);
+		test.p = (test.estimate == 0) ? 1 : 0;
+	}
+	return test;
+}
+
+HypothesisTest mann_whitney_u_test(uint64_t* a,
+								   size_t n_a,
+								   uint64_t* b,
+								   size_t n_b,
+								   double alpha)
+{
+	HypothesisTest test;
+	test.method = VerdictMethod::mann_whitney;
+	test.confidence = 1 - alpha;
+	if (n_a == 0 || n_b == 0) {
+		return test;
+	}
+
+	std::sort(a, a + n_a);
+	std::sort(b, b + n_b);
+
+	double ties = 0;
+	const double n1 = static_cast<double>(n_a);
+	const double n2 = static_cast<double>(n_b);
+	const double n = n1 + n2;
+	const double u = rank_sum(a, n_a, b, n_b, ties) - n1 * (n1 + 1) / 2;
+	const double mean_u = n1 * n2 / 2;
+	test.statistic = u;
+	// Positive when A tends to be larger (slower) than B.
+	test.effect_size = u / mean_u - 1;
+
+	// The variance of U, less what ties take away.
+	const double var_u = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)));
+	if (var_u > 0) {
+		const double sigma = sqrt(var_u);
+		// Continuity correction, toward the mean.
+		const double gap = fabs(u - mean_u);
+		const double z = std::max(gap - 0.5, 0.0) / sigma;
+		test.p = erfc(z / sqrt(2.0));
+
+		// Invert the test: the shifts of A it would not reject.
+		const double z_crit = normal_quantile(1 - alpha / 2);
+		test.estimate = solve_shift(a, n_a, b, n_b, mean_u);
+		test.ci_low = solve_shift(a, n_a, b, n_b, mean_u + z_crit * sigma);
+		test.ci_high = solve_shift(a, n_a, b, n_b, mean_u - z_crit * sigma);
+	} else {
+		// Every sample was identical.
+		test.p = 1;
+	}
+	return test;
+}
+
+uint64_t required_sample_size(VerdictMethod method,
+							  double std_dev,
+							  double difference,
+							  double alpha,
+							  double power)
+{
+	if (!(difference > 0)) {
+		return 0;
+	}
+	const double z_alpha = normal_quantile(1 - alpha / 2);
+	const double z_power = normal_quantile(power);
+	const double spread = (z_alpha + z_power) * std_dev / difference;
+	double n = spread * spread;
+
+	// Guenther's correction for using t rather than z.
+	const bool paired = (method == VerdictMethod::paired_t);
+	n += z_alpha * z_alpha / (paired ? 2 : 4);
+
+	// Rank tests are 3/pi as efficient as the t-test on normal data.
+	if (method == VerdictMethod::mann_whitney) {
+		n *= M_PI / 3;
+	}
+	// A test needs at least two samples to have any variance.
+	n = std::min(std::max(ceil(n), 2.0), static_cast<double>(UINT64_MAX / 2));
+	return static_cast<uint64_t>(n);
+}
@@ -0,0 +1,186 @@
+#include "goldilocks/streaming_stats.hpp"
+
+#include <algorithm>  // std::sort
+#include <cmath>      // isfinite, sqrt
+
+P2Quantile::P2Quantile(double p) : p(p)
+{
+	// Desired positions of the markers, and how far they move per sample.
+	this->np[0] = 1;
+	this->np[1] = 1 + 2 * p;
+	this->np[2] = 1 + 4 * p;
+	this->np[3] = 3 + 2 * p;
+	this->np[4] = 5;
+
+	this->dn[0] = 0;
+	this->dn[1] = p / 2;
+	this->dn[2] = p;
+	this->dn[3] = (1 + p) / 2;
+	this->dn[4] = 1;
+}
+
+double P2Quantile::parabolic(int i, int d) const
+{
+	return this->q[i] +
+		   d / (this->n[i + 1] - this->n[i - 1]) *
+			   ((this->n[i] - this->n[i - 1] + d) *
+					(this->q[i + 1] - this->q[i]) /
+					(this->n[i + 1] - this->n[i]) +
+				(this->n[i + 1] - this->n[i] - d) *
+					(this->q[i] - this->q[i - 1]) /
+					(this->n[i] - this->n[i - 1]));
+}
+
+double P2Quantile::linear(int i, int d) const
+{
+	return this->q[i] +
+		   d * (this->q[i + d] - this->q[i]) / (this->n[i + d] - this->n[i]);
+}
+
+void P2Quantile::add(double x)
+{
+	// The first five observations just become the marker heights.
+	if (this->count < 5) {
+		this->q[this->count++] = x;
+		if (this->count == 5) {
+			std::sort(this->q, this->q + 5);
+		}
+		return;
+	}
+	++this->count;
+
+	// Find the cell the observation falls in, extending the extremes.
+	int k;
+	if (x < this->q[0]) {
+		this->q[0] = x;
+		k = 0;
+	} else if (x < this->q[1]) {
+		k = 0;
+	} else if (x < this->q[2]) {
+		k = 1;
+	} else if (x < this->q[3]) {
+		k = 2;
+	} else if (x <= this->q[4]) {
+		k = 3;
+	} else {
+		this->q[4] = x;
+		k = 3;
+	}
+
+	// Shift the positions of the markers above the observation.
+	for (int i = k + 1; i < 5; ++i) {
+		this->n[i] += 1;
+	}
+	for (int i = 0; i < 5; ++i) {
+		this->np[i] += this->dn[i];
+	}
+
+	// Move the middle markers toward their desired positions.
+	for (int i = 1; i < 4; ++i) {
+		double d = this->np[i] - this->n[i];
+		if ((d >= 1 && this->n[i + 1] - this->n[i] > 1) ||
+			(d <= -1 && this->n[i - 1] - this->n[i] < -1)) {
+			int step = (d > 0) ? 1 : -1;
+			double height = this->parabolic(i, step);
+			// Fall back to linear if the parabola breaks marker order.
+			if (this->q[i - 1] < height && height < this->q[i + 1]) {
+				this->q[i] = height;
+			} else {
+				this->q[i] = this->linear(i, step);
+			}
+			this->n[i] += step;
+		}
+	}
+}
+
+double P2Quantile::estimate() const
+{
+	if (this->count == 0) {
+		return 0;
+	}
+	if (this->count > 5) {
+		return this->q[2];
+	}
+
+	/* Until the markers have moved, the middle one is the median whatever
+	 * the quantile; use the exact quantile of what we have instead.*/
+	double sorted[5];
+	std::copy(this->q, this->q + this->count, sorted);
+	std::sort(sorted, sorted + this->count);
+	return sorted[(uint64_t)(this->p * (this->count - 1) + 0.5)];
+}
+
+StreamingStats::StreamingStats(double fence_k)
+: fence_k(fence_k), q1_est(0.25), median_est(0.5), q3_est(0.75),
+  p99_est(0.99), p999_est(0.999), p9999_est(0.9999)
+{
+}
+
+void StreamingStats::add(double x)
+{
+	// Judge outliers against the fences as they stand before this sample.
+	bool outlier = false;
+	if (this->count >= 5 && std::isfinite(this->fence_k)) {
+		double q1 = this->q1_est.estimate();
+		double q3 = this->q3_est.estimate();
+		double iq = q3 - q1;
+		if (x < q1 - iq * this->fence_k) {
+			outlier = true;
+			if (x < q1 - iq * this->fence_k * 2) {
+				++this->low_out_major;
+			} else {
+				++this->low_out_minor;
+			}
+		} else if (x > q3 + iq * this->fence_k) {
+			outlier = true;
+			if (x > q3 + iq * this->fence_k * 2) {
+				++this->upp_out_major;
+			} else {
+				++this->upp_out_minor;
+			}
+		}
+	}
+
+	// Welford's method, for mean and variance without a stored series.
+	++this->count;
+	double delta = x - this->mean_val;
+	this->mean_val += delta / this->count;
+	this->m2 += delta * (x - this->mean_val);
+
+	if (this->count == 1 || x < this->min_val) {
+		this->min_val = x;
+	}
+	if (this->count == 1 || x > this->max_val) {
+		this->max_val = x;
+	}
+
+	this->q1_est.add(x);
+	this->median_est.add(x);
+	this->q3_est.add(x);
+	this->p99_est.add(x);
+	this->p999_est.add(x);
+	this->p9999_est.add(x);
+
+	// The same again, for only the non-outlier samples.
+	if (!outlier) {
+		++this->count_adj;
+		double delta_adj = x - this->mean_adj_val;
+		this->mean_adj_val += delta_adj / this->count_adj;
+		this->m2_adj += delta_adj * (x - this->mean_adj_val);
+
+		if (this->count_adj == 1 || x < this->min_adj_val) {
+			this->min_adj_val = x;
+		}
+		if (this->count_adj == 1 || x > this->max_adj_val) {
+			this->max_adj_val = x;
+		}
+	}
+}
+
+double StreamingStats::std_dev() const { return sqrt(this->variance()); }
+
+double StreamingStats::std_dev_adj() const
+{
+	return (this->count_adj > 1) ? sqrt(this->m2_adj / (this->count_adj - 1))
+								 : 0;
+}
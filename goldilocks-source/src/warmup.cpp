@@ -0,0 +1,36 @@
+#include "goldilocks/warmup.hpp"
+
+#include <algorithm>  // std::max, std::minmax_element, std::nth_element
+
+SteadyStateDetector::SteadyStateDetector(uint32_t window, double tolerance)
+: window(std::max(window, 1u)), tolerance(tolerance)
+{
+	this->current.reserve(this->window);
+}
+
+bool SteadyStateDetector::add(uint64_t measurement)
+{
+	this->current.push_back(measurement);
+	if (this->current.size() < this->window) {
+		return this->steady;
+	}
+
+	// Close the window, keeping only as many medians as we compare.
+	const size_t mid = this->current.size() / 2;
+	std::nth_element(this->current.begin(),
+					 this->current.begin() + mid,
+					 this->current.end());
+	this->medians.push_back(this->current[mid]);
+	this->current.clear();
+	if (this->medians.size() > STABLE_WINDOWS) {
+		this->medians.erase(this->medians.begin());
+	}
+
+	if (this->medians.size() == STABLE_WINDOWS) {
+		auto range =
+			std::minmax_element(this->medians.begin(), this->medians.end());
+		this->steady = (*range.second - *range.first <=
+						this->tolerance * static_cast<double>(*range.first));
+	}
+	return this->steady;
+}
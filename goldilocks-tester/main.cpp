@@ -47,6 +47,7 @@
 #include "goldilocks/expect/expect.hpp"
 #include "iosqueak/channel.hpp"
 #include "goldilocks/coordinator.hpp"
+#include "tests/run_tests.hpp"
 
 bool griffon(std::string, int) { return true; }
 
@@ -63,6 +64,8 @@ int add(int a, int b) { return a + b; }
 
 void test_code()
 {
+	run_tests();
+
 /*	/// Checks if two float numbers are approximately within a margin
 	std::cout << Expect<That::IsApproxEqual>(10.003f, 10.001f, 3) << std::endl;
 	std::cout << Expect<That::IsApproxEqual>(0.003f, 0.03f, 1) << std::endl;
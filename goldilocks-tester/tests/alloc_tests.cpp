@@ -0,0 +1,120 @@
+#include "alloc_tests.hpp"
+
+#include <memory>
+#include <stdexcept>  // std::runtime_error
+#include <vector>
+
+namespace {
+	/// How many times any of the functions below has been called.
+	int calls = 0;
+
+	/**Make one more allocation than there are elements, if there are any:
+	 * the vector's storage, then one block per element.
+	 * \param the number of elements
+	 * \return the number of elements made
+	 */
+	size_t allocate(size_t count)
+	{
+		++calls;
+		std::vector<std::unique_ptr<size_t>> blocks;
+		blocks.reserve(count);
+		for (size_t i = 0; i < count; ++i) {
+			blocks.push_back(std::make_unique<size_t>(i));
+		}
+		return blocks.size();
+	}
+
+	/**Allocate nothing.
+	 * \param the first addend
+	 * \param the second addend
+	 * \return the sum
+	 */
+	int add(int lhs, int rhs)
+	{
+		++calls;
+		return lhs + rhs;
+	}
+
+	/// Allocate a block, then throw.
+	void allocate_and_throw()
+	{
+		++calls;
+		std::unique_ptr<int> block = std::make_unique<int>(0);
+		throw std::runtime_error("Allocated, then threw");
+	}
+
+	/**Check how an outcome is judged, both as it should pass and as it
+	 * should fail.
+	 * \param the outcome
+	 * \param whether the evaluation itself should have passed
+	 * \return true if the outcome is judged as expected, else false
+	 */
+	bool judged(const OutcomePtr& outcome, bool passed)
+	{
+		return outcome->success(Should::Pass) == passed &&
+			   outcome->success(Should::Fail) == !passed;
+	}
+}  // namespace
+
+bool TestAlloc_AllocatesAtMost::run()
+{
+	calls = 0;
+	if (!AllocTracker::enabled()) {
+		// Nothing can be counted, so nothing passes, and nothing is run.
+		return judged(That::AllocatesAtMost::eval(100, "add", add, 1, 2),
+					  false) &&
+			   calls == 0;
+	}
+	return judged(That::AllocatesAtMost::eval(5, "allocate", allocate, 4),
+				  true) &&
+		   judged(That::AllocatesAtMost::eval(6, "allocate", allocate, 4),
+				  true) &&
+		   judged(That::AllocatesAtMost::eval(4, "allocate", allocate, 4),
+				  false) &&
+		   judged(That::AllocatesAtMost::eval(1, "allocate", allocate, 1),
+				  false) &&
+		   calls == 4;
+}
+
+bool TestAlloc_DoesNotAllocate::run()
+{
+	calls = 0;
+	if (!AllocTracker::enabled()) {
+		return judged(That::DoesNotAllocate::eval("add", add, 1, 2), false) &&
+			   calls == 0;
+	}
+	return judged(That::DoesNotAllocate::eval("add", add, 1, 2), true) &&
+		   judged(That::DoesNotAllocate::eval("allocate", allocate, 1),
+				  false) &&
+		   calls == 2;
+}
+
+bool TestAlloc_Throws::run()
+{
+	if (!AllocTracker::enabled()) {
+		return true;
+	}
+
+	bool threw = false;
+	try {
+		That::DoesNotAllocate::eval("allocate_and_throw", allocate_and_throw);
+	} catch (const std::runtime_error&) {
+		threw = true;
+	}
+
+	// Had tracking been left on, the allocation between these would count.
+	const AllocCounts before = AllocTracker::start();
+	AllocTracker::stop(before);
+	std::unique_ptr<int> block = std::make_unique<int>(0);
+	const AllocCounts after = AllocTracker::start();
+	AllocTracker::stop(after);
+
+	return threw && after.allocations == before.allocations;
+}
+
+void TestSuite_Alloc::load()
+{
+	this->register_item("G-tB1501", new TestAlloc_AllocatesAtMost);
+	this->register_item("G-tB1502", new TestAlloc_DoesNotAllocate);
+	this->register_item("G-tB1503", new TestAlloc_Throws);
+}
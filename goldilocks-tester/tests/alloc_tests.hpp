@@ -0,0 +1,101 @@
+/** Allocation Expectation Tests [Goldilocks Tester]
+ * Version: 2.0
+ *
+ * Checks that the allocation expectations pass and fail when they should.
+ *
+ * Author(s): Jason C. McDonald
+ */
+
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_TESTER_ALLOC_TESTS_HPP
+#define GOLDILOCKS_TESTER_ALLOC_TESTS_HPP
+
+#include "goldilocks/expect/expect.hpp"
+#include "goldilocks/suite.hpp"
+
+/** That::AllocatesAtMost passes within its limit and fails past it. */
+class TestAlloc_AllocatesAtMost : public Test
+{
+public:
+	TestAlloc_AllocatesAtMost()
+	: Test("Alloc: AllocatesAtMost",
+		   "AllocatesAtMost passes within its limit and fails past it.")
+	{
+	}
+
+	bool run() override;
+};
+
+/** That::DoesNotAllocate passes only when nothing is allocated. */
+class TestAlloc_DoesNotAllocate : public Test
+{
+public:
+	TestAlloc_DoesNotAllocate()
+	: Test("Alloc: DoesNotAllocate",
+		   "DoesNotAllocate passes only when nothing is allocated.")
+	{
+	}
+
+	bool run() override;
+};
+
+/** A function that throws doesn't leave the thread tracking. */
+class TestAlloc_Throws : public Test
+{
+public:
+	TestAlloc_Throws()
+	: Test("Alloc: Throws",
+		   "An exception passes through, and tracking stops behind it.")
+	{
+	}
+
+	bool run() override;
+};
+
+class TestSuite_Alloc : public TestSuite
+{
+public:
+	TestSuite_Alloc()
+	: TestSuite("Alloc", "Heap allocation expectations.")
+	{
+	}
+
+	void load() override;
+};
+
+#endif  // GOLDILOCKS_TESTER_ALLOC_TESTS_HPP
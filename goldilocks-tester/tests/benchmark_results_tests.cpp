@@ -0,0 +1,87 @@
+#include "benchmark_results_tests.hpp"
+
+#include <cmath>  // NAN
+
+namespace {
+	/**Finalize a benchmark of a test taking about 5 ticks a run against a
+	 * comparative taking about 8, with a clock whose noise floor is 20.
+	 * \param how many runs of the test were timed in each measurement
+	 * \param how many runs of the comparative were timed in each
+	 * measurement
+	 * \return the result
+	 */
+	BenchmarkResult finalize(uint64_t batch_test, uint64_t batch_comparative)
+	{
+		ClockOverhead overhead;
+		overhead.estimate = 30;
+		overhead.noise_floor = 20;
+
+		BenchmarkResult result;
+		result.set_overhead(overhead);
+		result.set_batch_sizes(batch_test, batch_comparative);
+		for (uint64_t i = 0; i < 100; ++i) {
+			result.add_measurement(5 + i % 2, 8 + i % 2);
+		}
+		result.finalize();
+		return result;
+	}
+}  // namespace
+
+bool TestBenchmarkResult_NoiseFloor::run()
+{
+	// 16 runs of each come to 80 and 128 ticks a measurement.
+	BenchmarkResult batched = finalize(16, 16);
+	// One run of each is within the noise, and so is one of the sides.
+	BenchmarkResult single = finalize(1, 1);
+	BenchmarkResult lopsided = finalize(16, 1);
+
+	return !batched.is_below_noise_floor() &&
+		   batched.get_verdict() == BenchmarkVerdict::win &&
+		   single.is_below_noise_floor() &&
+		   single.get_verdict() == BenchmarkVerdict::questionable &&
+		   lopsided.is_below_noise_floor();
+}
+
+bool TestBenchmarkResult_Uncounted::run()
+{
+	const size_t instructions = static_cast<size_t>(Counter::instructions);
+	CounterValues counted;
+	counted.fill(0);
+	CounterValues uncounted;
+	uncounted.fill(NAN);
+
+	// The test is clearly faster, and its instructions were never counted.
+	BenchmarkResult never;
+	never.set_counters(true, counter_bit(Counter::instructions));
+	never.set_metric(Metric::instructions);
+	for (uint64_t i = 0; i < 100; ++i) {
+		never.add_measurement(50 + i % 2, 80 + i % 2);
+		never.add_counts(uncounted, uncounted);
+	}
+	never.finalize();
+
+	// Only every other pair was counted, and only those are kept.
+	BenchmarkResult sometimes;
+	sometimes.set_counters(true, counter_bit(Counter::instructions));
+	sometimes.set_metric(Metric::instructions);
+	for (uint64_t i = 0; i < 100; ++i) {
+		counted[instructions] = 100 + i % 3;
+		sometimes.add_measurement(50 + i % 2, 80 + i % 2);
+		sometimes.add_counts(i % 2 ? counted : uncounted, counted);
+	}
+	sometimes.finalize();
+
+	return never.get_metric() == Metric::time &&
+		   never.get_verdict() == BenchmarkVerdict::win &&
+		   never.get_test_counts(Counter::instructions).size() == 0 &&
+		   sometimes.get_metric() == Metric::instructions &&
+		   sometimes.get_test_counts(Counter::instructions).size() == 50 &&
+		   sometimes.get_comparative_counts(Counter::instructions).size() ==
+			   100;
+}
+
+void TestSuite_BenchmarkResult::load()
+{
+	this->register_item("G-tB1601", new TestBenchmarkResult_NoiseFloor);
+	this->register_item("G-tB1602", new TestBenchmarkResult_Uncounted);
+}
@@ -0,0 +1,89 @@
+/** Benchmark Result Tests [Goldilocks Tester]
+ * Version: 2.0
+ *
+ * Checks how a benchmark result judges its measurements.
+ *
+ * Author(s): Jason C. McDonald
+ */
+
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_TESTER_BENCHMARK_RESULTS_TESTS_HPP
+#define GOLDILOCKS_TESTER_BENCHMARK_RESULTS_TESTS_HPP
+
+#include "goldilocks/benchmark_results.hpp"
+#include "goldilocks/suite.hpp"
+
+/** The noise floor is judged against whole batches, not single runs. */
+class TestBenchmarkResult_NoiseFloor : public Test
+{
+public:
+	TestBenchmarkResult_NoiseFloor()
+	: Test("BenchmarkResult: Noise floor",
+		   "Batched runs below the noise floor each, but above it per "
+		   "measurement, are trusted.")
+	{
+	}
+
+	bool run() override;
+};
+
+/** Counts that weren't taken are left out, not judged as zeros. */
+class TestBenchmarkResult_Uncounted : public Test
+{
+public:
+	TestBenchmarkResult_Uncounted()
+	: Test("BenchmarkResult: Uncounted",
+		   "Instructions that weren't counted fall back to judging on time.")
+	{
+	}
+
+	bool run() override;
+};
+
+class TestSuite_BenchmarkResult : public TestSuite
+{
+public:
+	TestSuite_BenchmarkResult()
+	: TestSuite("BenchmarkResult", "Statistics and verdicts of benchmarks.")
+	{
+	}
+
+	void load() override;
+};
+
+#endif  // GOLDILOCKS_TESTER_BENCHMARK_RESULTS_TESTS_HPP
@@ -0,0 +1,110 @@
+#include "bootstrap_tests.hpp"
+
+#include <cmath>  // log
+#include <initializer_list>
+#include <random>
+#include <vector>
+
+namespace {
+	/// The number of samples in each series.
+	const size_t SAMPLES = 50;
+
+	/// The number of independent experiments to judge coverage over.
+	const int TRIALS = 200;
+
+	/**Draw a series from a skewed distribution, like benchmark timings:
+	 * 1000 plus an exponential with a mean of 500.
+	 * \param the random generator
+	 * \return the series
+	 */
+	std::vector<uint64_t> draw(std::mt19937_64& rng)
+	{
+		std::exponential_distribution<double> timing(1.0 / 500);
+		std::vector<uint64_t> series(SAMPLES);
+		for (uint64_t& sample : series) {
+			sample = 1000 + (uint64_t)timing(rng);
+		}
+		return series;
+	}
+
+	/**Check whether an interval covers a value.
+	 * \param the interval
+	 * \param the value
+	 * \return true if the value is in the interval, else false
+	 */
+	bool covers(const BootstrapInterval& interval, double value)
+	{
+		return interval.low <= value && value <= interval.high;
+	}
+
+	/**Check whether two intervals are the same.
+	 * \param the first interval
+	 * \param the second interval
+	 * \return true if they match, else false
+	 */
+	bool same(const BootstrapInterval& lhs, const BootstrapInterval& rhs)
+	{
+		return lhs.estimate == rhs.estimate && lhs.low == rhs.low &&
+			   lhs.high == rhs.high;
+	}
+}  // namespace
+
+bool TestBootstrap_Coverage::run()
+{
+	// Truncating to whole ticks takes about half a tick off each.
+	const double true_mean = 1500 - 0.5;
+	const double true_median = 1000 + 500 * log(2.0);
+
+	std::mt19937_64 rng(12);
+	int mean_covered = 0;
+	int median_covered = 0;
+	int ratio_covered = 0;
+	for (int trial = 0; trial < TRIALS; ++trial) {
+		std::vector<uint64_t> a = draw(rng);
+		std::vector<uint64_t> b = draw(rng);
+		BootstrapResult result = bootstrap_intervals(
+			a.data(), a.size(), b.data(), b.size(), 1000, 0.95, 0, trial);
+
+		if (result.resamples != 1000 ||
+			!covers(result.mean_a, result.mean_a.estimate)) {
+			return false;
+		}
+		mean_covered += covers(result.mean_a, true_mean);
+		median_covered += covers(result.median_a, true_median);
+		ratio_covered += covers(result.median_ratio, 1);
+	}
+
+	// A binomial count of 95% of 200 is 190, give or take about 3.
+	for (int covered : {mean_covered, median_covered, ratio_covered}) {
+		if (covered < TRIALS * 89 / 100 || covered > TRIALS * 99 / 100) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool TestBootstrap_Seed::run()
+{
+	std::mt19937_64 rng(12);
+	std::vector<uint64_t> a = draw(rng);
+	std::vector<uint64_t> b = draw(rng);
+
+	BootstrapResult one =
+		bootstrap_intervals(a.data(), a.size(), b.data(), b.size(), 2000,
+							0.95, 1, 7);
+	BootstrapResult several =
+		bootstrap_intervals(a.data(), a.size(), b.data(), b.size(), 2000,
+							0.95, 4, 7);
+
+	return same(one.mean_a, several.mean_a) &&
+		   same(one.mean_b, several.mean_b) &&
+		   same(one.median_a, several.median_a) &&
+		   same(one.median_b, several.median_b) &&
+		   same(one.median_ratio, several.median_ratio);
+}
+
+void TestSuite_Bootstrap::load()
+{
+	this->register_item("G-tB1301", new TestBootstrap_Coverage);
+	this->register_item("G-tB1302", new TestBootstrap_Seed);
+}
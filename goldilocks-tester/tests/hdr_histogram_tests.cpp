@@ -0,0 +1,104 @@
+#include "hdr_histogram_tests.hpp"
+
+#include <initializer_list>
+#include <stdexcept>  // std::invalid_argument
+#include <string>
+
+namespace {
+	/// The percentiles checked by every test.
+	const double PERCENTILES[] = {0, 1, 25, 50, 75, 90, 99, 99.9, 99.99, 100};
+
+	/**Check that two histograms hold the same samples.
+	 * \param the first histogram
+	 * \param the second histogram
+	 * \return true if they match, else false
+	 */
+	bool same_samples(const HdrHistogram& lhs, const HdrHistogram& rhs)
+	{
+		if (lhs.size() != rhs.size() || lhs.min() != rhs.min() ||
+			lhs.max() != rhs.max()) {
+			return false;
+		}
+		for (double p : PERCENTILES) {
+			if (lhs.percentile(p) != rhs.percentile(p)) {
+				return false;
+			}
+		}
+		return true;
+	}
+}  // namespace
+
+bool TestHdrHistogram_Percentiles::run()
+{
+	HdrHistogram histogram;
+	for (uint64_t value = 1; value <= 1000000; ++value) {
+		histogram.record(value);
+	}
+
+	for (double p : PERCENTILES) {
+		// The exact value, and the furthest three figures allow above it.
+		uint64_t exact = (p == 0) ? 1 : (uint64_t)(p * 10000);
+		uint64_t value = histogram.percentile(p);
+		if (value < exact || value > exact + exact / 1000) {
+			return false;
+		}
+	}
+	return histogram.size() == 1000000 && histogram.min() == 1 &&
+		   histogram.max() == 1000000 &&
+		   histogram.count_between(1000, 1999) == 1000;
+}
+
+bool TestHdrHistogram_Merge::run()
+{
+	HdrHistogram whole;
+	HdrHistogram odd;
+	HdrHistogram even;
+	for (uint64_t value = 1; value <= 100000; ++value) {
+		// Spread over several orders of magnitude.
+		uint64_t sample = value * value % 10000019;
+		whole.record(sample);
+		(value % 2 ? odd : even).record(sample);
+	}
+	odd.merge(even);
+
+	bool refused = false;
+	try {
+		HdrHistogram coarse(HdrHistogram::DEFAULT_HIGHEST, 2);
+		coarse.merge(whole);
+	} catch (const std::invalid_argument&) {
+		refused = true;
+	}
+
+	return refused && same_samples(odd, whole);
+}
+
+bool TestHdrHistogram_Serialize::run()
+{
+	HdrHistogram histogram;
+	for (uint64_t value = 1; value <= 10000; ++value) {
+		histogram.record(value * 37 % 100003);
+	}
+	histogram.record(5000000000);
+
+	std::string data = histogram.serialize();
+	if (!same_samples(HdrHistogram::deserialize(data), histogram)) {
+		return false;
+	}
+
+	// Every truncation of the data must be refused.
+	for (size_t length = 0; length < data.size(); ++length) {
+		try {
+			HdrHistogram::deserialize(data.substr(0, length));
+			return false;
+		} catch (const std::invalid_argument&) {
+		}
+	}
+	return true;
+}
+
+void TestSuite_HdrHistogram::load()
+{
+	this->register_item("G-tB1101", new TestHdrHistogram_Percentiles);
+	this->register_item("G-tB1102", new TestHdrHistogram_Merge);
+	this->register_item("G-tB1103", new TestHdrHistogram_Serialize);
+}
@@ -0,0 +1,101 @@
+/** HDR Histogram Tests [Goldilocks Tester]
+ * Version: 2.0
+ *
+ * Checks histogram percentiles, merging and serialization.
+ *
+ * Author(s): Jason C. McDonald
+ */
+
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_TESTER_HDR_HISTOGRAM_TESTS_HPP
+#define GOLDILOCKS_TESTER_HDR_HISTOGRAM_TESTS_HPP
+
+#include "goldilocks/hdr_histogram.hpp"
+#include "goldilocks/suite.hpp"
+
+/** Percentiles are exact to the configured precision. */
+class TestHdrHistogram_Percentiles : public Test
+{
+public:
+	TestHdrHistogram_Percentiles()
+	: Test("HdrHistogram: Percentiles",
+		   "Percentiles are within three significant figures of exact ones.")
+	{
+	}
+
+	bool run() override;
+};
+
+/** Merging two histograms is the same as recording into one. */
+class TestHdrHistogram_Merge : public Test
+{
+public:
+	TestHdrHistogram_Merge()
+	: Test("HdrHistogram: Merge",
+		   "A merged histogram matches one that recorded every sample.")
+	{
+	}
+
+	bool run() override;
+};
+
+/** A histogram survives serialization, and truncated data is refused. */
+class TestHdrHistogram_Serialize : public Test
+{
+public:
+	TestHdrHistogram_Serialize()
+	: Test("HdrHistogram: Serialize",
+		   "Histograms round-trip through serialize(); truncated data throws.")
+	{
+	}
+
+	bool run() override;
+};
+
+class TestSuite_HdrHistogram : public TestSuite
+{
+public:
+	TestSuite_HdrHistogram()
+	: TestSuite("HdrHistogram", "High dynamic range sample storage.")
+	{
+	}
+
+	void load() override;
+};
+
+#endif  // GOLDILOCKS_TESTER_HDR_HISTOGRAM_TESTS_HPP
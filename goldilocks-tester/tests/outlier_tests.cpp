@@ -0,0 +1,163 @@
+#include "outlier_tests.hpp"
+
+#include <cmath>  // INFINITY, NAN
+#include <initializer_list>
+#include <stdexcept>  // std::invalid_argument
+#include <vector>
+
+namespace {
+	/**Build a series of 100 samples spread evenly over [1000, 1100), with
+	 * some outliers added.
+	 * \param the outliers to add
+	 * \return the series, shuffled
+	 */
+	std::vector<uint64_t> series_with(std::initializer_list<uint64_t> outliers)
+	{
+		std::vector<uint64_t> series;
+		for (uint64_t i = 0; i < 100; ++i) {
+			series.push_back(1000 + i * 37 % 100);
+		}
+		series.insert(series.end(), outliers);
+		return series;
+	}
+
+	/**Finalize a series, as both sides of a benchmark, and take A's
+	 * statistics.
+	 * \param how to store the samples
+	 * \param the outlier policy
+	 * \param the series
+	 * \return the statistics of the series
+	 */
+	SeriesStats finalize(SampleStorage storage,
+						 const OutlierPolicy& policy,
+						 const std::vector<uint64_t>& series)
+	{
+		BenchmarkResult result;
+		result.set_storage(storage);
+		result.set_outlier_policy(policy);
+		for (uint64_t sample : series) {
+			result.add_measurement(sample, sample);
+		}
+		result.finalize();
+		return result.get_test_stats();
+	}
+
+	/**Check the outlier counts of a series, stored both raw and in a
+	 * histogram, and that every other sample was retained.
+	 * \param the outlier policy
+	 * \param the series
+	 * \param the expected number of low major outliers
+	 * \param the expected number of low minor outliers
+	 * \param the expected number of upper minor outliers
+	 * \param the expected number of upper major outliers
+	 * \return true if the counts match in both, else false
+	 */
+	bool counts_match(const OutlierPolicy& policy,
+					  const std::vector<uint64_t>& series,
+					  uint64_t low_major,
+					  uint64_t low_minor,
+					  uint64_t upp_minor,
+					  uint64_t upp_major)
+	{
+		for (SampleStorage storage :
+			 {SampleStorage::raw, SampleStorage::histogram}) {
+			SeriesStats stats = finalize(storage, policy, series);
+			const uint64_t outliers =
+				low_major + low_minor + upp_minor + upp_major;
+			if (stats.outliers.method != policy.method ||
+				stats.low_out_major != low_major ||
+				stats.low_out_minor != low_minor ||
+				stats.upp_out_minor != upp_minor ||
+				stats.upp_out_major != upp_major ||
+				stats.retained_first != low_major + low_minor ||
+				stats.retained_last - stats.retained_first + 1 !=
+					series.size() - outliers) {
+				return false;
+			}
+		}
+		return true;
+	}
+}  // namespace
+
+bool TestOutliers_Tukey::run()
+{
+	/* The quartiles are near 1025 and 1075, so the inner fences are near
+	 * 950 and 1150, and the outer fences near 875 and 1225.*/
+	return counts_match(OutlierPolicy::tukey(),
+						series_with({500, 800, 920, 1180, 1190, 5000}),
+						2, 1, 2, 1) &&
+		   // Twice as far out, only the furthest are still outliers.
+		   counts_match(OutlierPolicy::tukey(3),
+						series_with({500, 800, 920, 1180, 1190, 5000}),
+						1, 1, 0, 1);
+}
+
+bool TestOutliers_MAD::run()
+{
+	/* The median is near 1050 and the MAD near 25, so three scaled MADs
+	 * out puts the inner fences near 940 and 1160, and the outer fences
+	 * near 830 and 1270.*/
+	return counts_match(OutlierPolicy::mad(),
+						series_with({700, 900, 1200, 1210, 2000}),
+						1, 1, 2, 1);
+}
+
+bool TestOutliers_Trim::run()
+{
+	// 5% of 100 samples is 5 off each end, and trimmed samples are minor.
+	return counts_match(OutlierPolicy::trim(5), series_with({}), 0, 5, 5, 0) &&
+		   counts_match(OutlierPolicy::trim(0), series_with({}), 0, 0, 0, 0);
+}
+
+bool TestOutliers_None::run()
+{
+	return counts_match(OutlierPolicy::none(),
+						series_with({1, 500, 5000, 100000}),
+						0, 0, 0, 0);
+}
+
+bool TestOutliers_Narrow::run()
+{
+	/* The median of 10 and 20 is 15, with a MAD of 5, so fences a tenth of
+	 * a scaled MAD out leave both samples outside them.*/
+	SeriesStats raw =
+		finalize(SampleStorage::raw, OutlierPolicy::mad(0.1), {10, 20});
+	if (raw.outliers.method != OutlierMethod::none ||
+		raw.low_out_minor + raw.low_out_major + raw.upp_out_minor +
+				raw.upp_out_major !=
+			0 ||
+		raw.mean_adj != 15 || raw.min_adj_val != 10 || raw.max_adj_val != 20) {
+		return false;
+	}
+
+	// A histogram's median is a real sample, which its fences keep.
+	SeriesStats histogram =
+		finalize(SampleStorage::histogram, OutlierPolicy::mad(0.1), {10, 20});
+	if (histogram.low_out_minor + histogram.low_out_major +
+			histogram.upp_out_minor + histogram.upp_out_major !=
+		1) {
+		return false;
+	}
+
+	for (OutlierPolicy policy : {OutlierPolicy::tukey(0),
+								 OutlierPolicy::mad(-1),
+								 OutlierPolicy::tukey(INFINITY),
+								 OutlierPolicy::trim(NAN)}) {
+		try {
+			BenchmarkResult result;
+			result.set_outlier_policy(policy);
+			return false;
+		} catch (const std::invalid_argument&) {
+		}
+	}
+	return true;
+}
+
+void TestSuite_Outliers::load()
+{
+	this->register_item("G-tB1401", new TestOutliers_Tukey);
+	this->register_item("G-tB1402", new TestOutliers_MAD);
+	this->register_item("G-tB1403", new TestOutliers_Trim);
+	this->register_item("G-tB1404", new TestOutliers_None);
+	this->register_item("G-tB1405", new TestOutliers_Narrow);
+}
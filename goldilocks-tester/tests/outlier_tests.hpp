@@ -0,0 +1,128 @@
+/** Outlier Policy Tests [Goldilocks Tester]
+ * Version: 2.0
+ *
+ * Checks which samples each outlier policy fences out.
+ *
+ * Author(s): Jason C. McDonald
+ */
+
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_TESTER_OUTLIER_TESTS_HPP
+#define GOLDILOCKS_TESTER_OUTLIER_TESTS_HPP
+
+#include "goldilocks/benchmark_results.hpp"
+#include "goldilocks/suite.hpp"
+
+/** Tukey's fences count samples by interquartile ranges out. */
+class TestOutliers_Tukey : public Test
+{
+public:
+	TestOutliers_Tukey()
+	: Test("Outliers: Tukey",
+		   "Tukey's fences count minor and major outliers on each side.")
+	{
+	}
+
+	bool run() override;
+};
+
+/** MAD fences count samples by scaled median absolute deviations out. */
+class TestOutliers_MAD : public Test
+{
+public:
+	TestOutliers_MAD()
+	: Test("Outliers: MAD",
+		   "MAD fences count minor and major outliers on each side.")
+	{
+	}
+
+	bool run() override;
+};
+
+/** Trimming fences off a fixed share of each end. */
+class TestOutliers_Trim : public Test
+{
+public:
+	TestOutliers_Trim()
+	: Test("Outliers: Trim",
+		   "Trimming fences off the given percentage of each end.")
+	{
+	}
+
+	bool run() override;
+};
+
+/** Without a policy, every sample is kept. */
+class TestOutliers_None : public Test
+{
+public:
+	TestOutliers_None()
+	: Test("Outliers: None", "Without an outlier policy, every sample is kept.")
+	{
+	}
+
+	bool run() override;
+};
+
+/** Fences that leave nothing between them keep every sample instead, and
+ * fences that can't keep anything are refused. */
+class TestOutliers_Narrow : public Test
+{
+public:
+	TestOutliers_Narrow()
+	: Test("Outliers: Narrow",
+		   "Fences with nothing between them keep every sample; zero, "
+		   "negative and infinite fences are refused.")
+	{
+	}
+
+	bool run() override;
+};
+
+class TestSuite_Outliers : public TestSuite
+{
+public:
+	TestSuite_Outliers()
+	: TestSuite("Outliers", "Outlier policies for benchmark series.")
+	{
+	}
+
+	void load() override;
+};
+
+#endif  // GOLDILOCKS_TESTER_OUTLIER_TESTS_HPP
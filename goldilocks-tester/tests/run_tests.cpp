@@ -0,0 +1,103 @@
+#include "run_tests.hpp"
+
+#include <algorithm>  // std::sort
+#include <iostream>
+#include <vector>
+
+#include "goldilocks/suite.hpp"
+
+#include "alloc_tests.hpp"
+#include "benchmark_results_tests.hpp"
+#include "bootstrap_tests.hpp"
+#include "hdr_histogram_tests.hpp"
+#include "outlier_tests.hpp"
+#include "statistics_tests.hpp"
+#include "streaming_stats_tests.hpp"
+
+namespace {
+	/**Take a test through its lifecycle once.
+	 * \param the test
+	 * \return true if the test passed, else false
+	 */
+	bool run_test(Test* test)
+	{
+		if (!test->pre()) {
+			test->prefail();
+			return false;
+		}
+		if (test->janitor() && test->run() && test->verify()) {
+			test->post();
+			return true;
+		}
+		test->postmortem();
+		return false;
+	}
+
+	/**Load a suite and run its items in name order. Goldilocks owns the
+	 * tests registered to it, so each is deleted once it has run.
+	 * \param the suite
+	 * \return the number of tests that failed
+	 */
+	unsigned int run_suite(TestSuite& suite)
+	{
+		suite.load();
+
+		std::vector<itemname_t> names;
+		for (const auto& item : suite.runnables) {
+			names.push_back(item.first);
+		}
+		std::sort(names.begin(), names.end());
+
+		std::cout << "===== " << suite.suite_name << " =====" << std::endl;
+		unsigned int failed = 0;
+		for (const itemname_t& name : names) {
+			Runnable& item = suite.runnables.at(name);
+			if (Test** test = std::get_if<Test*>(&item)) {
+				bool passed = run_test(*test);
+				std::cout << (passed ? "[PASS] " : "[FAIL] ") << name << ": "
+						  << (*test)->doc_string << std::endl;
+				if (!passed) {
+					++failed;
+				}
+				delete *test;
+			} else if (TestSuite** inner = std::get_if<TestSuite*>(&item)) {
+				failed += run_suite(**inner);
+			}
+		}
+		suite.runnables.clear();
+		return failed;
+	}
+}  // namespace
+
+unsigned int run_tests()
+{
+	unsigned int failed = 0;
+
+	TestSuite_StreamingStats streaming_stats;
+	failed += run_suite(streaming_stats);
+
+	TestSuite_HdrHistogram hdr_histogram;
+	failed += run_suite(hdr_histogram);
+
+	TestSuite_Statistics statistics;
+	failed += run_suite(statistics);
+
+	TestSuite_Bootstrap bootstrap;
+	failed += run_suite(bootstrap);
+
+	TestSuite_Outliers outliers;
+	failed += run_suite(outliers);
+
+	TestSuite_Alloc alloc;
+	failed += run_suite(alloc);
+
+	TestSuite_BenchmarkResult benchmark_result;
+	failed += run_suite(benchmark_result);
+
+	if (failed == 0) {
+		std::cout << "All tests passed." << std::endl;
+	} else {
+		std::cout << failed << " test(s) failed." << std::endl;
+	}
+	return failed;
+}
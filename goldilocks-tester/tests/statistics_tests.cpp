@@ -0,0 +1,84 @@
+#include "statistics_tests.hpp"
+
+#include <cmath>  // fabs
+
+/* The expected values below were found by integrating the t density and
+ * from the normal distribution directly, to more places than are checked.*/
+
+namespace {
+	/**Check that a value is within an absolute tolerance of the known one.
+	 * \param the value
+	 * \param the known value
+	 * \param the tolerance
+	 * \return true if the value is close enough, else false
+	 */
+	bool is_near(double value, double known, double tolerance)
+	{
+		return fabs(value - known) <= tolerance;
+	}
+}  // namespace
+
+bool TestStatistics_StudentT::run()
+{
+	return is_near(student_t_two_sided(2, 10), 0.0733880, 1e-6) &&
+		   is_near(student_t_two_sided(-2, 10), 0.0733880, 1e-6) &&
+		   is_near(student_t_two_sided(2.2281389, 10), 0.05, 1e-6) &&
+		   is_near(student_t_critical(0.05, 10), 2.2281389, 1e-5) &&
+		   is_near(normal_cdf(1.959964), 0.975, 1e-6);
+}
+
+bool TestStatistics_PairedT::run()
+{
+	// A mean difference of 1 over 16 pairs with a deviation of 2: t = 2.
+	HypothesisTest test = paired_t_test(1, 2, 16, 0.05);
+
+	// The interval is 1 +/- t(0.05, 15) * 0.5, with t(0.05, 15) = 2.13145.
+	return test.method == VerdictMethod::paired_t &&
+		   is_near(test.statistic, 2, 1e-12) && is_near(test.df, 15, 1e-12) &&
+		   is_near(test.p, 0.0639450, 1e-6) &&
+		   is_near(test.ci_low, 1 - 2.1314495 * 0.5, 1e-5) &&
+		   is_near(test.ci_high, 1 + 2.1314495 * 0.5, 1e-5) &&
+		   is_near(test.effect_size, 0.5, 1e-12);
+}
+
+bool TestStatistics_WelchT::run()
+{
+	/* The standard error is sqrt(4/10 + 9/15) = 1, so t = -2, with
+	 * 1 / (0.4^2/9 + 0.6^2/14) = 22.9927 degrees of freedom.*/
+	HypothesisTest test = welch_t_test(10, 2, 10, 12, 3, 15, 0.05);
+
+	return test.method == VerdictMethod::welch_t &&
+		   is_near(fabs(test.statistic), 2, 1e-12) &&
+		   is_near(test.df, 22.9927007, 1e-6) &&
+		   is_near(test.p, 0.0574484, 1e-6) &&
+		   is_near(test.estimate, -2, 1e-12);
+}
+
+bool TestStatistics_MannWhitneyU::run()
+{
+	// Every A below every B: U = 0, z = (50 - 0.5) / sqrt(175).
+	uint64_t low[10] = {10, 9, 8, 7, 6, 5, 4, 3, 2, 1};
+	uint64_t high[10] = {11, 12, 13, 14, 15, 16, 17, 18, 19, 20};
+	HypothesisTest apart = mann_whitney_u_test(low, 10, high, 10, 0.05);
+
+	// Odd and even numbers interleaved: U = 45, z = (5 - 0.5) / sqrt(175).
+	uint64_t odd[10] = {1, 3, 5, 7, 9, 11, 13, 15, 17, 19};
+	uint64_t even[10] = {2, 4, 6, 8, 10, 12, 14, 16, 18, 20};
+	HypothesisTest mixed = mann_whitney_u_test(odd, 10, even, 10, 0.05);
+
+	// The shift is searched for, so it is only near the exact -10.
+	return apart.method == VerdictMethod::mann_whitney &&
+		   is_near(apart.statistic, 0, 1e-12) &&
+		   is_near(apart.p, 0.000182672, 1e-8) &&
+		   is_near(apart.estimate, -10, 0.01) &&
+		   is_near(mixed.statistic, 45, 1e-12) &&
+		   is_near(mixed.p, 0.7337300, 1e-6);
+}
+
+void TestSuite_Statistics::load()
+{
+	this->register_item("G-tB1201", new TestStatistics_StudentT);
+	this->register_item("G-tB1202", new TestStatistics_PairedT);
+	this->register_item("G-tB1203", new TestStatistics_WelchT);
+	this->register_item("G-tB1204", new TestStatistics_MannWhitneyU);
+}
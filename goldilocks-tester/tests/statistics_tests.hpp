@@ -0,0 +1,114 @@
+/** Hypothesis Test Tests [Goldilocks Tester]
+ * Version: 2.0
+ *
+ * Checks the verdict's hypothesis tests against known p-values.
+ *
+ * Author(s): Jason C. McDonald
+ */
+
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_TESTER_STATISTICS_TESTS_HPP
+#define GOLDILOCKS_TESTER_STATISTICS_TESTS_HPP
+
+#include "goldilocks/statistics.hpp"
+#include "goldilocks/suite.hpp"
+
+/** The Student's t distribution gives known tail probabilities. */
+class TestStatistics_StudentT : public Test
+{
+public:
+	TestStatistics_StudentT()
+	: Test("Statistics: Student's t",
+		   "Two-sided t probabilities and critical values match tables.")
+	{
+	}
+
+	bool run() override;
+};
+
+/** The paired t-test gives the known p-value and interval. */
+class TestStatistics_PairedT : public Test
+{
+public:
+	TestStatistics_PairedT()
+	: Test("Statistics: Paired t-test",
+		   "The paired t-test gives the known statistic, p-value and interval.")
+	{
+	}
+
+	bool run() override;
+};
+
+/** Welch's t-test gives the known degrees of freedom and p-value. */
+class TestStatistics_WelchT : public Test
+{
+public:
+	TestStatistics_WelchT()
+	: Test("Statistics: Welch's t-test",
+		   "Welch's t-test gives the known degrees of freedom and p-value.")
+	{
+	}
+
+	bool run() override;
+};
+
+/** The Mann-Whitney U test gives the known U and p-value. */
+class TestStatistics_MannWhitneyU : public Test
+{
+public:
+	TestStatistics_MannWhitneyU()
+	: Test("Statistics: Mann-Whitney U test",
+		   "The Mann-Whitney U test gives the known U, p-value and shift.")
+	{
+	}
+
+	bool run() override;
+};
+
+class TestSuite_Statistics : public TestSuite
+{
+public:
+	TestSuite_Statistics()
+	: TestSuite("Statistics", "Hypothesis tests for benchmark verdicts.")
+	{
+	}
+
+	void load() override;
+};
+
+#endif  // GOLDILOCKS_TESTER_STATISTICS_TESTS_HPP
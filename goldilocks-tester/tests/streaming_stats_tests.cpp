@@ -0,0 +1,135 @@
+#include "streaming_stats_tests.hpp"
+
+#include <algorithm>  // std::min_element, std::max_element, std::nth_element
+#include <cmath>      // fabs, INFINITY
+#include <initializer_list>
+#include <random>
+
+namespace {
+	/**Check that a value is within a relative tolerance of the exact one.
+	 * \param the value
+	 * \param the exact value
+	 * \param the tolerance, as a fraction of the exact value
+	 * \return true if the value is close enough, else false
+	 */
+	bool is_close(double value, double exact, double tolerance)
+	{
+		return fabs(value - exact) <= tolerance * fabs(exact);
+	}
+
+	/**Find the exact quantile of a series, as the nearest rank.
+	 * \param the series, which will be reordered
+	 * \param the quantile, in [0, 1]
+	 * \return the quantile
+	 */
+	double exact_quantile(std::vector<double>& series, double p)
+	{
+		size_t rank = (size_t)(p * (series.size() - 1) + 0.5);
+		std::nth_element(series.begin(), series.begin() + rank, series.end());
+		return series[rank];
+	}
+}  // namespace
+
+bool TestStreamingStats_Moments::pre()
+{
+	std::mt19937_64 rng(8);
+	std::lognormal_distribution<double> timing(5, 0.5);
+	this->samples.resize(10000);
+	for (double& sample : this->samples) {
+		sample = timing(rng);
+	}
+	return true;
+}
+
+bool TestStreamingStats_Moments::run()
+{
+	StreamingStats stats;
+	double sum = 0;
+	for (double sample : this->samples) {
+		stats.add(sample);
+		sum += sample;
+	}
+
+	double mean = sum / this->samples.size();
+	double squares = 0;
+	for (double sample : this->samples) {
+		squares += (sample - mean) * (sample - mean);
+	}
+	double variance = squares / (this->samples.size() - 1);
+
+	return stats.size() == this->samples.size() &&
+		   is_close(stats.mean(), mean, 1e-12) &&
+		   is_close(stats.variance(), variance, 1e-9) &&
+		   stats.min() == *std::min_element(this->samples.begin(),
+											this->samples.end()) &&
+		   stats.max() == *std::max_element(this->samples.begin(),
+											this->samples.end());
+}
+
+void TestStreamingStats_Moments::post() { this->samples.clear(); }
+
+bool TestStreamingStats_Quantiles::pre()
+{
+	std::mt19937_64 rng(8);
+	std::uniform_real_distribution<double> timing(1000, 2000);
+	this->samples.resize(100000);
+	for (double& sample : this->samples) {
+		sample = timing(rng);
+	}
+	return true;
+}
+
+bool TestStreamingStats_Quantiles::run()
+{
+	StreamingStats stats;
+	for (double sample : this->samples) {
+		stats.add(sample);
+	}
+
+	return is_close(stats.q1(), exact_quantile(this->samples, 0.25), 0.01) &&
+		   is_close(stats.median(), exact_quantile(this->samples, 0.5), 0.01) &&
+		   is_close(stats.q3(), exact_quantile(this->samples, 0.75), 0.01) &&
+		   is_close(stats.p99(), exact_quantile(this->samples, 0.99), 0.01);
+}
+
+void TestStreamingStats_Quantiles::post() { this->samples.clear(); }
+
+bool TestStreamingStats_Outliers::run()
+{
+	/* Every hundredth of [100, 110), shuffled, so the inner fences sit near
+	 * 95 and 115 and the outer fences near 87.5 and 122.5.*/
+	StreamingStats fenced;
+	StreamingStats unfenced(INFINITY);
+	double sum = 0;
+	for (int i = 0; i < 1000; ++i) {
+		double sample = 100 + (i * 619 % 1000) / 100.0;
+		fenced.add(sample);
+		unfenced.add(sample);
+		sum += sample;
+
+		// Once the quartiles have settled, add a few of each kind.
+		if (i >= 500 && i % 50 == 0) {
+			for (double outlier : {0.0, 92.0, 118.0, 118.0, 1000.0}) {
+				fenced.add(outlier);
+				unfenced.add(outlier);
+			}
+		}
+	}
+
+	return fenced.size() == 1050 && fenced.low_major() == 10 &&
+		   fenced.low_minor() == 10 && fenced.upper_minor() == 20 &&
+		   fenced.upper_major() == 10 && fenced.size_adj() == 1000 &&
+		   is_close(fenced.mean_adj(), sum / 1000, 1e-12) &&
+		   fenced.min_adj() >= 100 && fenced.max_adj() < 110 &&
+		   unfenced.size_adj() == unfenced.size() &&
+		   unfenced.low_major() + unfenced.low_minor() +
+				   unfenced.upper_minor() + unfenced.upper_major() ==
+			   0;
+}
+
+void TestSuite_StreamingStats::load()
+{
+	this->register_item("G-tB1001", new TestStreamingStats_Moments);
+	this->register_item("G-tB1002", new TestStreamingStats_Quantiles);
+	this->register_item("G-tB1003", new TestStreamingStats_Outliers);
+}
@@ -0,0 +1,116 @@
+/** Streaming Statistics Tests [Goldilocks Tester]
+ * Version: 2.0
+ *
+ * Checks the constant-memory statistics against exact ones.
+ *
+ * Author(s): Jason C. McDonald
+ */
+
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2021 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef GOLDILOCKS_TESTER_STREAMING_STATS_TESTS_HPP
+#define GOLDILOCKS_TESTER_STREAMING_STATS_TESTS_HPP
+
+#include <vector>
+
+#include "goldilocks/streaming_stats.hpp"
+#include "goldilocks/suite.hpp"
+
+/** Welford's mean and variance, and the extremes, are exact. */
+class TestStreamingStats_Moments : public Test
+{
+protected:
+	/// The samples, kept to work the exact statistics out from.
+	std::vector<double> samples;
+
+public:
+	TestStreamingStats_Moments()
+	: Test("StreamingStats: Moments",
+		   "Mean, variance, minimum and maximum match the exact statistics.")
+	{
+	}
+
+	bool pre() override;
+	bool run() override;
+	void post() override;
+};
+
+/** The P-squared quantile estimates are close to the exact ones. */
+class TestStreamingStats_Quantiles : public Test
+{
+protected:
+	/// The samples, kept to work the exact quantiles out from.
+	std::vector<double> samples;
+
+public:
+	TestStreamingStats_Quantiles()
+	: Test("StreamingStats: Quantiles",
+		   "Quartile and tail estimates land within 1% of the exact ones.")
+	{
+	}
+
+	bool pre() override;
+	bool run() override;
+	void post() override;
+};
+
+/** Samples past the Tukey fences are counted, and left out of the
+ * adjusted statistics. */
+class TestStreamingStats_Outliers : public Test
+{
+public:
+	TestStreamingStats_Outliers()
+	: Test("StreamingStats: Outliers",
+		   "Outliers are counted by fence and kept out of adjusted statistics.")
+	{
+	}
+
+	bool run() override;
+};
+
+class TestSuite_StreamingStats : public TestSuite
+{
+public:
+	TestSuite_StreamingStats()
+	: TestSuite("StreamingStats", "Constant-memory benchmark statistics.")
+	{
+	}
+
+	void load() override;
+};
+
+#endif  // GOLDILOCKS_TESTER_STREAMING_STATS_TESTS_HPP